@@ -225,6 +225,7 @@ QDeferred<RetTypes...> QDeferred<Types...>::thenAlias(
 
 	// create deferred to return
 	QDeferred<RetTypes...> retPromise;
+	QDEFERRED_TRACE_LINK(m_data->m_traceId, QDeferredDataBase::traceIdOf(retPromise));
 
 	// add intermediate done nameless callback
 	m_data->done([doneCallback, retPromise](Types(...args1)) mutable {
@@ -3,11 +3,21 @@ CONFIG -= flat
 
 INCLUDEPATH += $$PWD/
 
+!contains( DEFINES, QEVENTMAILBOX_USED ) {
+    include($$PWD/qeventmailbox.pri)
+}
+
+!contains( DEFINES, QSHAREDPAYLOAD_USED ) {
+    include($$PWD/qsharedpayload.pri)
+}
+
 OTHER_FILES  = QDeferred.natvis
 
 HEADERS     += $$PWD/qdeferred.hpp \
-               $$PWD/qdeferreddata.hpp
+               $$PWD/qdeferreddata.hpp \
+               $$PWD/qdeferredtrace.hpp
 
-SOURCES     += $$PWD/qdeferreddata.cpp
+SOURCES     += $$PWD/qdeferreddata.cpp \
+               $$PWD/qdeferredtrace.cpp
 
 DEFINES     += QDEFERRED_USED
\ No newline at end of file
@@ -2,13 +2,20 @@
 
 #include <QDebug>
 
-QDeferredProxyObject::QDeferredProxyObject() : QObject(nullptr)
+QDeferredProxyObject::QDeferredProxyObject() : QObject(nullptr),
+	m_mailbox(this, QDEFERREDPROXY_MAILBOX_EVENT_TYPE, Qt::HighEventPriority)
 {
 	// nothing to do here
 }
 
 bool QDeferredProxyObject::event(QEvent * ev)
 {
+	if (ev->type() == QDEFERREDPROXY_MAILBOX_EVENT_TYPE) {
+		// call all queued functions
+		m_mailbox.drain();
+		// return event processed
+		return true;
+	}
 	if (ev->type() == QDEFERREDPROXY_EVENT_TYPE) {
 		// call function
 		static_cast<QDeferredProxyEvent*>(ev)->m_eventFunc();
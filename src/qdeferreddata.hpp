@@ -7,14 +7,20 @@
 #include <QThread>
 #include <QMutex>
 #include <QMap>
+#include <QSharedPointer>
 #include <functional>
 #include <QObject>
 #include <QEvent>
 
 #include <QDebug>
 
+#include "qeventmailbox.hpp"
+#include "qdeferredtrace.hpp"
+
 // custom event to be used in qt event loop for each thread
 #define QDEFERREDPROXY_EVENT_TYPE (QEvent::Type)(QEvent::User + 123)
+// wakeup event of the mailbox used to queue the callbacks for each thread
+#define QDEFERREDPROXY_MAILBOX_EVENT_TYPE (QEvent::Type)(QEvent::User + 124)
 
 class QDeferredProxyObject : public QObject
 {
@@ -24,8 +30,20 @@ public:
 
 	bool event(QEvent* ev);
 
+	// queue function to be executed in the thread of this object
+	template<typename F>
+	void post(F &&func);
+
+private:
+	QEventMailbox m_mailbox;
 };
 
+template<typename F>
+void QDeferredProxyObject::post(F &&func)
+{
+	m_mailbox.post(std::forward<F>(func));
+}
+
 class QDeferredProxyEvent : public QEvent
 {
 public:
@@ -89,6 +107,15 @@ protected:
 	static QMap< QThread *, QDeferredProxyObject * > s_threadMap;
 
 	static QMutex s_mutex;
+
+#ifdef QDEFERRED_TRACE
+	// trace id of any deferred, used to link 'then' chain stages
+	template<class ...OtherTypes>
+	static quint64 traceIdOf(const QDeferred<OtherTypes...> &defer)
+	{
+		return defer.m_data->m_traceId;
+	}
+#endif
 };
 
 // [GCC_DEF_FIX]
@@ -157,6 +184,10 @@ public:
 	int m_whenCount = 0;
 	// blocking event loop
 	QEventLoop* m_blockingEventLoop;
+#ifdef QDEFERRED_TRACE
+	// id of this deferred in the exported trace
+	quint64 m_traceId;
+#endif
 
 private:
 	// struct to store callback data
@@ -199,6 +230,7 @@ QDeferredData<Types...>::QDeferredData() :
 	// NOTE : compiling below or in init list m_finishedFunction(nullptr)
 	//        randomly fails to compile
 	//m_finishedFunction = nullptr;
+	QDEFERRED_TRACE_CREATE(m_traceId);
 }
 
 template<class ...Types>
@@ -224,7 +256,7 @@ m_connectionList(other.m_connectionList),
 m_finishedFunction(other.m_finishedFunction),
 m_blockingEventLoop(other.m_blockingEventLoop)
 {
-	// nothing to do here
+	QDEFERRED_TRACE_CREATE(m_traceId);
 }
 
 template<class ...Types>
@@ -241,6 +273,7 @@ void QDeferredData<Types...>::done(const std::function<void(Types(&...args))> &c
 	QMutexLocker locker(&m_mutex);
 	if (m_state == QDeferredState::RESOLVED)
 	{
+		QDEFERRED_TRACE_SCOPE("done", m_traceId);
 		Q_ASSERT(m_finishedFunction);
 		m_finishedFunction(callback);
 	}
@@ -267,6 +300,7 @@ void QDeferredData<Types...>::fail(const std::function<void(Types(&...args))> &c
 	//        subscribes a fail callback. Thats how we arrive here with a m_finishedFunction == nullptr
 	if (m_finishedFunction && m_state == QDeferredState::REJECTED)
 	{
+		QDEFERRED_TRACE_SCOPE("fail", m_traceId);
 		m_finishedFunction(callback);
 	}
 	else
@@ -291,6 +325,7 @@ void QDeferredData<Types...>::progress(const std::function<void(Types(&...args))
 template<class ...Types>
 void QDeferredData<Types...>::resolve(QDeferred<Types...> ref, Types(&...args))
 {
+	QDEFERRED_TRACE_SCOPE("resolve", m_traceId);
 	QMutexLocker locker(&m_mutex);
 	// early exit if deferred has been already resolved or rejected
 	Q_ASSERT_X(m_state == QDeferredState::PENDING, "QDeferred", "Cannot resolve already processed deferred object.");
@@ -328,22 +363,21 @@ void QDeferredData<Types...>::resolve(QDeferred<Types...> ref, Types(&...args))
 			if (currConnection == Qt::DirectConnection || (currConnection == Qt::AutoConnection && p_currThread == QThread::currentThread()))
 			{
 				Q_ASSERT(m_finishedFunction);
+				QDEFERRED_TRACE_SCOPE("done", m_traceId);
 				// call directly with arguments
 				m_finishedFunction(currCallback);
 			}
 			else if (currConnection == Qt::QueuedConnection || (currConnection == Qt::AutoConnection && p_currThread != QThread::currentThread()))
 			{
-				// create object in heap and assign function (event loop takes ownership and deletes it later)
-				QDeferredProxyEvent * p_Evt = new QDeferredProxyEvent;
-				p_Evt->m_eventFunc = [ref, this, currCallback]() mutable {
+				// queue function in the mailbox of the object with correct thread affinity (event loop wakes up once per batch)
+				p_currObject->post([ref, this, currCallback]() mutable {
 					Q_ASSERT(m_finishedFunction);
+					QDEFERRED_TRACE_SCOPE("done", m_traceId);
 					// call in thread with arguments
 					m_finishedFunction(currCallback);
 					// unused, but we need it to keep at least one reference until all callbacks are executed
 					Q_UNUSED(ref)
-				};
-				// post event for object with correct thread affinity
-				QCoreApplication::postEvent(p_currObject, p_Evt, Qt::HighEventPriority);
+				});
 			}
 			else
 			{
@@ -359,21 +393,20 @@ void QDeferredData<Types...>::resolve(QDeferred<Types...> ref, Types(&...args))
 			// execute according to connection type
 			if (currConnection == Qt::DirectConnection || (currConnection == Qt::AutoConnection && p_currThread == QThread::currentThread()))
 			{
+				QDEFERRED_TRACE_SCOPE("done", m_traceId);
 				// call directly
 				currCallback();
 			}
 			else if (currConnection == Qt::QueuedConnection || (currConnection == Qt::AutoConnection && p_currThread != QThread::currentThread()))
 			{
-				// create object in heap and assign function (event loop takes ownership and deletes it later)
-				QDeferredProxyEvent* p_Evt = new QDeferredProxyEvent;
-				p_Evt->m_eventFunc = [ref, this, currCallback]() mutable {
+				// queue function in the mailbox of the object with correct thread affinity (event loop wakes up once per batch)
+				p_currObject->post([ref, this, currCallback]() mutable {
+					QDEFERRED_TRACE_SCOPE("done", m_traceId);
 					// call in thread
 					currCallback();
 					// unused, but we need it to keep at least one reference until all callbacks are executed
 					Q_UNUSED(ref)
-				};
-				// post event for object with correct thread affinity
-				QCoreApplication::postEvent(p_currObject, p_Evt, Qt::HighEventPriority);
+				});
 			}
 			else
 			{
@@ -394,6 +427,7 @@ void QDeferredData<Types...>::resolve(QDeferred<Types...> ref, Types(&...args))
 template<class ...Types>
 void QDeferredData<Types...>::reject(QDeferred<Types...> ref, Types(&...args))
 {
+	QDEFERRED_TRACE_SCOPE("reject", m_traceId);
 	QMutexLocker locker(&m_mutex);
 	// early exit if deferred has been already resolved or rejected
 	Q_ASSERT_X(m_state == QDeferredState::PENDING, "QDeferred", "Cannot reject already processed deferred object.");
@@ -431,22 +465,21 @@ void QDeferredData<Types...>::reject(QDeferred<Types...> ref, Types(&...args))
 			if (currConnection == Qt::DirectConnection || (currConnection == Qt::AutoConnection && p_currThread == QThread::currentThread()))
 			{
 				Q_ASSERT(m_finishedFunction);
+				QDEFERRED_TRACE_SCOPE("fail", m_traceId);
 				// call directly with arguments
 				m_finishedFunction(currCallback);
 			}
 			else if (currConnection == Qt::QueuedConnection || (currConnection == Qt::AutoConnection && p_currThread != QThread::currentThread()))
 			{
-				// create object in heap and assign function (event loop takes ownership and deletes it later)
-				QDeferredProxyEvent* p_Evt = new QDeferredProxyEvent;
-				p_Evt->m_eventFunc = [ref, this, currCallback]() mutable {
+				// queue function in the mailbox of the object with correct thread affinity (event loop wakes up once per batch)
+				p_currObject->post([ref, this, currCallback]() mutable {
 					Q_ASSERT(m_finishedFunction);
+					QDEFERRED_TRACE_SCOPE("fail", m_traceId);
 					// call in thread with arguments
 					m_finishedFunction(currCallback);
 					// unused, but we need it to keep at least one reference until all callbacks are executed
 					Q_UNUSED(ref)
-				};
-				// post event for object with correct thread affinity
-				QCoreApplication::postEvent(p_currObject, p_Evt, Qt::HighEventPriority);
+				});
 			}
 			else
 			{
@@ -462,21 +495,20 @@ void QDeferredData<Types...>::reject(QDeferred<Types...> ref, Types(&...args))
 			// execute according to connection type
 			if (currConnection == Qt::DirectConnection || (currConnection == Qt::AutoConnection && p_currThread == QThread::currentThread()))
 			{
+				QDEFERRED_TRACE_SCOPE("fail", m_traceId);
 				// call directly
 				currCallback();
 			}
 			else if (currConnection == Qt::QueuedConnection || (currConnection == Qt::AutoConnection && p_currThread != QThread::currentThread()))
 			{
-				// create object in heap and assign function (event loop takes ownership and deletes it later)
-				QDeferredProxyEvent* p_Evt = new QDeferredProxyEvent;
-				p_Evt->m_eventFunc = [ref, this, currCallback]() mutable {
+				// queue function in the mailbox of the object with correct thread affinity (event loop wakes up once per batch)
+				p_currObject->post([ref, this, currCallback]() mutable {
+					QDEFERRED_TRACE_SCOPE("fail", m_traceId);
 					// call in thread
 					currCallback();
 					// unused, but we need it to keep at least one reference until all callbacks are executed
 					Q_UNUSED(ref)
-				};
-				// post event for object with correct thread affinity
-				QCoreApplication::postEvent(p_currObject, p_Evt, Qt::HighEventPriority);
+				});
 			}
 			else
 			{
@@ -497,6 +529,7 @@ void QDeferredData<Types...>::reject(QDeferred<Types...> ref, Types(&...args))
 template<class ...Types>
 void QDeferredData<Types...>::rejectZero(QDeferred<Types...> ref)
 {
+	QDEFERRED_TRACE_SCOPE("reject", m_traceId);
 	QMutexLocker locker(&m_mutex);
 	// early exit if deferred has been already resolved or rejected
 	Q_ASSERT_X(m_state == QDeferredState::PENDING, "QDeferred", "Cannot reject already processed deferred object.");
@@ -531,21 +564,20 @@ void QDeferredData<Types...>::rejectZero(QDeferred<Types...> ref)
 			// execute according to connection type
 			if (currConnection == Qt::DirectConnection || (currConnection == Qt::AutoConnection && p_currThread == QThread::currentThread()))
 			{
+				QDEFERRED_TRACE_SCOPE("fail", m_traceId);
 				// call directly
 				currCallback();
 			}
 			else if (currConnection == Qt::QueuedConnection || (currConnection == Qt::AutoConnection && p_currThread != QThread::currentThread()))
 			{
-				// create object in heap and assign function (event loop takes ownership and deletes it later)
-				QDeferredProxyEvent* p_Evt = new QDeferredProxyEvent;
-				p_Evt->m_eventFunc = [ref, this, currCallback]() mutable {
+				// queue function in the mailbox of the object with correct thread affinity (event loop wakes up once per batch)
+				p_currObject->post([ref, this, currCallback]() mutable {
+					QDEFERRED_TRACE_SCOPE("fail", m_traceId);
 					// call in thread
 					currCallback();
 					// unused, but we need it to keep at least one reference until all callbacks are executed
 					Q_UNUSED(ref)
-				};
-				// post event for object with correct thread affinity
-				QCoreApplication::postEvent(p_currObject, p_Evt, Qt::HighEventPriority);
+				});
 			}
 			else
 			{
@@ -563,6 +595,7 @@ void QDeferredData<Types...>::rejectZero(QDeferred<Types...> ref)
 template<class ...Types>
 void QDeferredData<Types...>::notify(QDeferred<Types...> ref, Types(&...args))
 {
+	QDEFERRED_TRACE_SCOPE("notify", m_traceId);
 	QMutexLocker locker(&m_mutex);
 	// early exit if deferred has been already resolved or rejected
 	Q_ASSERT_X(m_state == QDeferredState::PENDING, "QDeferred", "Cannot notify already processed deferred object.");
@@ -575,7 +608,9 @@ void QDeferredData<Types...>::notify(QDeferred<Types...> ref, Types(&...args))
 	// with notify we cannot use execute -> m_finishedFunction combo because; if notify-events are
 	// not processed inmediatly after, then progress callbacks will be called with incorrect arguments
 	// (with the last agruments that were given to the last notify call, e.g. "3, 3, 3", instead of "1, 2, 3")
-	auto funcCacheArgs = std::bind(GCC_DEF_FIX::finishedFunctionTemplate<Types...>, std::placeholders::_1, args...);
+	// NOTE : args are copied once and shared by all queued callbacks, instead of once per callback
+	typedef std::function<void(std::function<void(Types(&...args))>)> FuncCacheArgs;
+	auto funcCacheArgs = QSharedPointer<FuncCacheArgs>(new FuncCacheArgs(std::bind(GCC_DEF_FIX::finishedFunctionTemplate<Types...>, std::placeholders::_1, args...)));
 
 	// for each thread where there are callbacks to be called
 	QMapIterator< QThread*, DeferredAllCallbacks*> i(m_callbacksMap);
@@ -594,21 +629,20 @@ void QDeferredData<Types...>::notify(QDeferred<Types...> ref, Types(&...args))
 			// execute according to connection type
 			if (currConnection == Qt::DirectConnection || (currConnection == Qt::AutoConnection && p_currThread == QThread::currentThread()))
 			{
+				QDEFERRED_TRACE_SCOPE("progress", m_traceId);
 				// call directly
-				funcCacheArgs(currCallback);
+				(*funcCacheArgs)(currCallback);
 			}
 			else if (currConnection == Qt::QueuedConnection || (currConnection == Qt::AutoConnection && p_currThread != QThread::currentThread()))
 			{
-				// create object in heap and assign function (event loop takes ownership and deletes it later)
-				QDeferredProxyEvent* p_Evt = new QDeferredProxyEvent;
-				p_Evt->m_eventFunc = [ref, this, funcCacheArgs, currCallback]() mutable {
+				// queue function in the mailbox of the object with correct thread affinity (event loop wakes up once per batch)
+				p_currObject->post([ref, this, funcCacheArgs, currCallback]() mutable {
+					QDEFERRED_TRACE_SCOPE("progress", m_traceId);
 					// call in thread
-					funcCacheArgs(currCallback);
+					(*funcCacheArgs)(currCallback);
 					// unused, but we need it to keep at least one reference until all callbacks are executed
 					Q_UNUSED(ref)
-				};
-				// post event for object with correct thread affinity
-				QCoreApplication::postEvent(p_currObject, p_Evt, Qt::HighEventPriority);
+				});
 			}
 			else
 			{
@@ -626,6 +660,7 @@ void QDeferredData<Types...>::doneZero(const std::function<void()> &callback,
 	QMutexLocker locker(&m_mutex);
 	if (m_state == QDeferredState::RESOLVED)
 	{
+		QDEFERRED_TRACE_SCOPE("done", m_traceId);
 		callback();
 	}
 	else
@@ -645,6 +680,7 @@ void QDeferredData<Types...>::failZero(const std::function<void()> &callback,
 	QMutexLocker locker(&m_mutex);
 	if (m_state == QDeferredState::REJECTED)
 	{
+		QDEFERRED_TRACE_SCOPE("fail", m_traceId);
 		callback();
 	}
 	else
@@ -0,0 +1,181 @@
+#include "qdeferredtrace.hpp"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QFile>
+
+// QDEFERREDTRACEBUFFER -----------------------------------------------------
+
+QDeferredTraceBuffer::QDeferredTraceBuffer(const int &intTid, const QString &strName) :
+	m_intTid(intTid),
+	m_strName(strName),
+	m_written(0),
+	m_read(0)
+{
+	// nothing to do here
+}
+
+void QDeferredTraceBuffer::append(const QDeferredTraceEvent &event)
+{
+	quint64 written = m_written.loadAcquire();
+	// full, drop instead of blocking the traced thread
+	if (written - m_read.loadAcquire() >= QDEFERRED_TRACE_CAPACITY)
+	{
+		QDeferredTrace::s_dropped.fetchAndAddRelaxed(1);
+		return;
+	}
+	m_events[written % QDEFERRED_TRACE_CAPACITY] = event;
+	// publish
+	m_written.storeRelease(written + 1);
+}
+
+void QDeferredTraceBuffer::take(QList<QDeferredTraceEvent> &listEvents)
+{
+	quint64 read    = m_read.loadAcquire();
+	quint64 written = m_written.loadAcquire();
+	for (quint64 i = read; i < written; i++)
+	{
+		listEvents.append(m_events[i % QDEFERRED_TRACE_CAPACITY]);
+	}
+	// release slots to the writer
+	m_read.storeRelease(written);
+}
+
+// QDEFERREDTRACE -----------------------------------------------------------
+
+QAtomicInteger<quint64> QDeferredTrace::s_nextId(0);
+QAtomicInteger<quint64> QDeferredTrace::s_dropped(0);
+QList<QDeferredTraceBuffer *> QDeferredTrace::s_buffers;
+QMutex QDeferredTrace::s_mutex;
+
+quint64 QDeferredTrace::create()
+{
+	quint64 id = s_nextId.fetchAndAddRelaxed(1) + 1;
+	QDeferredTraceBuffer * p_buffer = QDeferredTrace::bufferForThread();
+	p_buffer->append({ QDeferredTrace::nowNs(), "create", id, 0, 'B', 's' });
+	p_buffer->append({ QDeferredTrace::nowNs(), "create", id, 0, 'E', 0 });
+	return id;
+}
+
+void QDeferredTrace::begin(const char * name, const quint64 &id, const quint64 &linkId/* = 0*/)
+{
+	QDeferredTrace::bufferForThread()->append({ QDeferredTrace::nowNs(), name, id, linkId, 'B', 't' });
+}
+
+void QDeferredTrace::end(const char * name)
+{
+	QDeferredTrace::bufferForThread()->append({ QDeferredTrace::nowNs(), name, 0, 0, 'E', 0 });
+}
+
+void QDeferredTrace::link(const quint64 &parentId, const quint64 &childId)
+{
+	QDeferredTrace::begin("then", parentId, childId);
+	QDeferredTrace::end("then");
+}
+
+QByteArray QDeferredTrace::takeChromeTrace()
+{
+	QMutexLocker locker(&QDeferredTrace::s_mutex);
+	return "{\"traceEvents\":[\n" + QDeferredTrace::takeEvents() + "\n]}\n";
+}
+
+bool QDeferredTrace::flush(const QString &strFilePath)
+{
+	QMutexLocker locker(&QDeferredTrace::s_mutex);
+	QByteArray byteEvents = QDeferredTrace::takeEvents();
+	QFile file(strFilePath);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		return false;
+	}
+	// NOTE : the closing bracket of the json array format is optional, which allows appending on each flush
+	QByteArray bytePrefix = file.size() == 0 ? "[\n" : ",\n";
+	bool ok = file.write(bytePrefix + byteEvents) == bytePrefix.size() + byteEvents.size();
+	file.close();
+	return ok;
+}
+
+quint64 QDeferredTrace::droppedCount()
+{
+	return s_dropped.loadAcquire();
+}
+
+qint64 QDeferredTrace::nowNs()
+{
+	static QElapsedTimer clock = []() {
+		QElapsedTimer timer;
+		timer.start();
+		return timer;
+	}();
+	return clock.nsecsElapsed();
+}
+
+QDeferredTraceBuffer * QDeferredTrace::bufferForThread()
+{
+	static thread_local QDeferredTraceBuffer * tp_buffer = nullptr;
+	if (!tp_buffer)
+	{
+		QMutexLocker locker(&QDeferredTrace::s_mutex);
+		QThread * p_currThd = QThread::currentThread();
+		int intTid = QDeferredTrace::s_buffers.count() + 1;
+		QString strName = p_currThd->objectName();
+		if (strName.isEmpty())
+		{
+			bool isMain = QCoreApplication::instance() && QCoreApplication::instance()->thread() == p_currThd;
+			strName = isMain ? QString("Main Thread") : QString("Thread %1").arg(intTid);
+		}
+		tp_buffer = new QDeferredTraceBuffer(intTid, strName);
+		QDeferredTrace::s_buffers.append(tp_buffer);
+	}
+	return tp_buffer;
+}
+
+QByteArray QDeferredTrace::takeEvents()
+{
+	// NOTE : called with s_mutex locked
+	auto toUs = [](const qint64 &ns) {
+		return QByteArray::number((double)ns / 1000.0, 'f', 3);
+	};
+	QByteArray byteEvents = "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"QDeferred\"}}";
+	for (int i = 0; i < QDeferredTrace::s_buffers.count(); i++)
+	{
+		QDeferredTraceBuffer * p_buffer = QDeferredTrace::s_buffers.at(i);
+		QByteArray byteTid  = QByteArray::number(p_buffer->m_intTid);
+		QByteArray byteName = p_buffer->m_strName.toUtf8().replace('\\', "\\\\").replace('"', "\\\"");
+		byteEvents += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":" + byteTid + ",\"args\":{\"name\":\"" + byteName + "\"}}";
+		QList<QDeferredTraceEvent> listEvents;
+		p_buffer->take(listEvents);
+		for (int k = 0; k < listEvents.count(); k++)
+		{
+			const QDeferredTraceEvent &event = listEvents.at(k);
+			QByteArray byteTs = toUs(event.tsNs);
+			QByteArray byteHead = "{\"name\":\"" + QByteArray(event.name) + "\",\"cat\":\"qdeferred\",\"pid\":2,\"tid\":" + byteTid + ",\"ts\":" + byteTs;
+			if (event.phase == 'E')
+			{
+				byteEvents += ",\n" + byteHead + ",\"ph\":\"E\"}";
+				continue;
+			}
+			QByteArray byteId = QByteArray::number(event.id);
+			QByteArray byteArgs = "{\"id\":" + byteId;
+			if (event.linkId != 0)
+			{
+				byteArgs += ",\"link\":" + QByteArray::number(event.linkId);
+			}
+			byteEvents += ",\n" + byteHead + ",\"ph\":\"B\",\"args\":" + byteArgs + "}}";
+			// NOTE : flow events bind to the enclosing slice ("bp":"e"), which is the one just begun
+			if (event.flow != 0)
+			{
+				byteEvents += ",\n{\"name\":\"deferred\",\"cat\":\"qdeferred\",\"ph\":\"" + QByteArray(1, event.flow) + "\",\"bp\":\"e\",\"id\":" + byteId +
+				              ",\"pid\":2,\"tid\":" + byteTid + ",\"ts\":" + byteTs + "}";
+			}
+			// the child of a 'then' link starts its own flow on creation, step on it so both flows meet here
+			if (event.linkId != 0)
+			{
+				byteEvents += ",\n{\"name\":\"deferred\",\"cat\":\"qdeferred\",\"ph\":\"t\",\"bp\":\"e\",\"id\":" + QByteArray::number(event.linkId) +
+				              ",\"pid\":2,\"tid\":" + byteTid + ",\"ts\":" + byteTs + "}";
+			}
+		}
+	}
+	return byteEvents;
+}
@@ -0,0 +1,115 @@
+#ifndef QDEFERREDTRACE_H
+#define QDEFERREDTRACE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <QAtomicInteger>
+
+// NOTE : tracing of the deferred lifecycles is compiled in only if QDEFERRED_TRACE is defined
+//        (e.g. DEFINES += QDEFERRED_TRACE in the .pro file), otherwise the hooks below expand to nothing
+#ifdef QDEFERRED_TRACE
+#define QDEFERRED_TRACE_CREATE(id)              id = QDeferredTrace::create()
+#define QDEFERRED_TRACE_SCOPE(name, id)         QDeferredTraceScope qdeferredTraceScope(name, id)
+#define QDEFERRED_TRACE_LINK(parentId, childId) QDeferredTrace::link(parentId, childId)
+#else
+#define QDEFERRED_TRACE_CREATE(id)
+#define QDEFERRED_TRACE_SCOPE(name, id)
+#define QDEFERRED_TRACE_LINK(parentId, childId)
+#endif
+
+// events per thread buffer, events that do not fit until the next flush are dropped
+#ifndef QDEFERRED_TRACE_CAPACITY
+#define QDEFERRED_TRACE_CAPACITY 16384
+#endif
+
+// single trace event, name must be a string literal
+struct QDeferredTraceEvent
+{
+	qint64       tsNs;
+	const char * name;
+	// deferred the event belongs to (flow id)
+	quint64      id;
+	// linked deferred (then), zero if none
+	quint64      linkId;
+	// 'B' begin or 'E' end of slice
+	char         phase;
+	// flow event bound to a begin, 's' start, 't' step or zero if none
+	char         flow;
+};
+
+// events of one thread, single writer (owner thread), single reader (flush, serialized by a mutex)
+class QDeferredTraceBuffer
+{
+public:
+	explicit QDeferredTraceBuffer(const int &intTid, const QString &strName);
+
+	void append(const QDeferredTraceEvent &event);
+	// move all events written so far to the list
+	void take(QList<QDeferredTraceEvent> &listEvents);
+
+	int     m_intTid;
+	QString m_strName;
+
+private:
+	Q_DISABLE_COPY(QDeferredTraceBuffer)
+	QDeferredTraceEvent     m_events[QDEFERRED_TRACE_CAPACITY];
+	QAtomicInteger<quint64> m_written;
+	QAtomicInteger<quint64> m_read;
+};
+
+// process wide recorder of the deferred lifecycles, exported in chrome trace event format (chrome://tracing, perfetto)
+// NOTE : each deferred is a flow, creation starts it and resolve/reject/notify, callbacks and 'then' links step on it
+class QDeferredTrace
+{
+public:
+	// new deferred, returns its id
+	static quint64 create();
+	// begin and end of a slice in the current thread
+	static void begin(const char * name, const quint64 &id, const quint64 &linkId = 0);
+	static void end(const char * name);
+	// 'then' chain stage, child is the deferred returned by then
+	static void link(const quint64 &parentId, const quint64 &childId);
+
+	// take all recorded events as a complete trace (json object)
+	static QByteArray takeChromeTrace();
+	// take all recorded events and append them to the trace file (json array, may be called repeatedly)
+	static bool flush(const QString &strFilePath);
+
+	// events dropped because a thread buffer was full
+	static quint64 droppedCount();
+
+	static qint64 nowNs();
+
+private:
+	static QDeferredTraceBuffer * bufferForThread();
+	static QByteArray takeEvents();
+
+	static QAtomicInteger<quint64> s_nextId;
+	static QAtomicInteger<quint64> s_dropped;
+	// NOTE : buffers are never freed, so that events of threads still running at exit stay valid
+	static QList<QDeferredTraceBuffer *> s_buffers;
+	static QMutex s_mutex;
+	friend class QDeferredTraceBuffer;
+};
+
+// begin on construction, end on destruction
+class QDeferredTraceScope
+{
+public:
+	QDeferredTraceScope(const char * name, const quint64 &id) : mp_name(name)
+	{
+		QDeferredTrace::begin(name, id);
+	}
+	~QDeferredTraceScope()
+	{
+		QDeferredTrace::end(mp_name);
+	}
+
+private:
+	Q_DISABLE_COPY(QDeferredTraceScope)
+	const char * mp_name;
+};
+
+#endif // QDEFERREDTRACE_H
@@ -15,6 +15,8 @@ public:
 	virtual void off(QString strEventName)           = 0;
 	virtual void off(QDynamicEventsHandle evtHandle) = 0;
 	virtual void off()                               = 0;
+	// copy sharing the same subscriptions
+	virtual QAbstractDynamicEvents * clone() const   = 0;
 };
 
 // NOTE : must declare a virtual destruct, otherwise derived classes' destructors are not called
@@ -35,20 +37,39 @@ public:
 	// consumer API
 
 	// on method	
-	QDynamicEventsHandle on(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection);
+	// NOTE : rate limits the calls, e.g. QDynamicEventsRate::throttle(33) for a ~30 Hz GUI handler
+	QDynamicEventsHandle on(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection, Qt::EventPriority priority = Qt::NormalEventPriority, QDynamicEventsRate rate = QDynamicEventsRate());
 	// once method	
-	QDynamicEventsHandle once(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection);
+	QDynamicEventsHandle once(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection, Qt::EventPriority priority = Qt::NormalEventPriority);
 	// off method (all callbacks registered to an specific event name)
 	void off(QString strEventName);
 	// off method (specific callback based on handle)
 	void off(QDynamicEventsHandle evtHandle);
 	// off method (all callbacks)
 	void off();
+	// copy sharing the same subscriptions
+	QAbstractDynamicEvents * clone() const;
+
+	// retained API
+
+	// enable or disable retained mode, last triggered args are delivered to callbacks subscribed later
+	void setRetained(QString strEventName, bool retained = true);
+	// check if retained mode is enabled
+	bool isRetained(QString strEventName);
+	// forget last triggered args, retained mode stays enabled
+	void clearRetained(QString strEventName);
 
 	// provider API
 
 	// trigger event method
 	void trigger(QString strEventName, Types(&...args));
+	// trigger event method, queued callbacks are delivered in the lane of the given priority
+	void trigger(const Qt::EventPriority &priority, QString strEventName, Types(&...args));
+
+	// metrics
+
+	// queue depth of each delivery lane (High, Normal, Low) of a thread
+	static QList<QDynamicEventsLaneMetrics> laneMetrics(QThread * p_thread = QThread::currentThread());
 
 protected:
 	QExplicitlySharedDataPointer<QDynamicEventsData<Types...>> m_data;
@@ -88,15 +109,15 @@ QDynamicEvents<Types...>::~QDynamicEvents()
 }
 
 template<class ...Types>
-QDynamicEventsHandle QDynamicEvents<Types...>::on(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/)
+QDynamicEventsHandle QDynamicEvents<Types...>::on(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/, Qt::EventPriority priority/* = Qt::NormalEventPriority*/, QDynamicEventsRate rate/* = QDynamicEventsRate()*/)
 {
-	return m_data->on(strEventName, callback, filter, connection);
+	return m_data->on(strEventName, callback, filter, connection, priority, rate);
 }
 
 template<class ...Types>
-QDynamicEventsHandle QDynamicEvents<Types...>::once(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/)
+QDynamicEventsHandle QDynamicEvents<Types...>::once(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/, Qt::EventPriority priority/* = Qt::NormalEventPriority*/)
 {
-	return m_data->once(strEventName, callback, filter, connection);
+	return m_data->once(strEventName, callback, filter, connection, priority);
 }
 
 template<class ...Types>
@@ -117,6 +138,30 @@ void QDynamicEvents<Types...>::off()
 	m_data->off();
 }
 
+template<class ...Types>
+QAbstractDynamicEvents * QDynamicEvents<Types...>::clone() const
+{
+	return new QDynamicEvents<Types...>(*this);
+}
+
+template<class ...Types>
+void QDynamicEvents<Types...>::setRetained(QString strEventName, bool retained/* = true*/)
+{
+	m_data->setRetained(strEventName, retained);
+}
+
+template<class ...Types>
+bool QDynamicEvents<Types...>::isRetained(QString strEventName)
+{
+	return m_data->isRetained(strEventName);
+}
+
+template<class ...Types>
+void QDynamicEvents<Types...>::clearRetained(QString strEventName)
+{
+	m_data->clearRetained(strEventName);
+}
+
 template<class ...Types>
 void QDynamicEvents<Types...>::trigger(QString strEventName, Types(&...args))
 {
@@ -124,4 +169,17 @@ void QDynamicEvents<Types...>::trigger(QString strEventName, Types(&...args))
 	m_data->trigger(*this, strEventName, args...);
 }
 
+template<class ...Types>
+void QDynamicEvents<Types...>::trigger(const Qt::EventPriority &priority, QString strEventName, Types(&...args))
+{
+	// pass reference to this to at least have 1 reference until callbacks get executed
+	m_data->trigger(*this, priority, strEventName, args...);
+}
+
+template<class ...Types>
+QList<QDynamicEventsLaneMetrics> QDynamicEvents<Types...>::laneMetrics(QThread * p_thread/* = QThread::currentThread()*/)
+{
+	return QDynamicEventsData<Types...>::laneMetrics(p_thread);
+}
+
 #endif // QDYNAMICEVENTS_H
\ No newline at end of file
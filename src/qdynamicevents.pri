@@ -3,6 +3,14 @@ CONFIG -= flat
 
 INCLUDEPATH += $$PWD/
 
+!contains( DEFINES, QEVENTMAILBOX_USED ) {
+    include($$PWD/qeventmailbox.pri)
+}
+
+!contains( DEFINES, QSHAREDPAYLOAD_USED ) {
+    include($$PWD/qsharedpayload.pri)
+}
+
 HEADERS  += $$PWD/qdynamicevents.hpp \
             $$PWD/qdynamiceventsdata.hpp
 
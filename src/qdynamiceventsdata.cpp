@@ -1,12 +1,20 @@
 #include "qdynamicevents.hpp"
 
-QDynamicEventsProxyObject::QDynamicEventsProxyObject() : QObject(nullptr)
+QDynamicEventsProxyObject::QDynamicEventsProxyObject() : QObject(nullptr),
+	m_mailbox(this, QDYNAMICEVENTSPROXY_MAILBOX_EVENT_TYPE, QList<int>() << Qt::HighEventPriority << Qt::NormalEventPriority << Qt::LowEventPriority, QDYNAMICEVENTSPROXY_MAX_STREAK),
+	m_wheelTimerId(0)
 {
 	// nothing to do here
 }
 
 bool QDynamicEventsProxyObject::event(QEvent * ev)
 {
+	if (ev->type() == QDYNAMICEVENTSPROXY_MAILBOX_EVENT_TYPE) {
+		// call all queued functions
+		m_mailbox.drain();
+		// return event processed
+		return true;
+	}
 	if (ev->type() == QDYNAMICEVENTSPROXY_EVENT_TYPE) {
 		// call function
 		static_cast<QDynamicEventsProxyEvent*>(ev)->m_eventFunc();
@@ -17,6 +25,163 @@ bool QDynamicEventsProxyObject::event(QEvent * ev)
 	return QObject::event(ev);
 }
 
+QList<QDynamicEventsLaneMetrics> QDynamicEventsProxyObject::laneMetrics() const
+{
+	QList<QDynamicEventsLaneMetrics> listMetrics;
+	for (int i = 0; i < m_mailbox.laneCount(); i++)
+	{
+		QDynamicEventsLaneMetrics metrics;
+		metrics.priority = static_cast<Qt::EventPriority>(m_mailbox.lanePriority(i));
+		metrics.depth    = m_mailbox.depth(i);
+		metrics.maxDepth = m_mailbox.maxDepth(i);
+		listMetrics.append(metrics);
+	}
+	return listMetrics;
+}
+
+void QDynamicEventsProxyObject::schedule(qint64 deadlineMs, std::function<void()> func)
+{
+	// the wheel is only touched in the thread of this object
+	this->post([this, deadlineMs, func]() {
+		m_timerWheel.schedule(QDynamicEventsTimerWheel::elapsedMs(), deadlineMs, func);
+		if (m_wheelTimerId == 0)
+		{
+			m_wheelTimerId = this->startTimer(m_timerWheel.tickMs(), Qt::PreciseTimer);
+		}
+	}, Qt::HighEventPriority);
+}
+
+void QDynamicEventsProxyObject::timerEvent(QTimerEvent * ev)
+{
+	if (ev->timerId() != m_wheelTimerId)
+	{
+		QObject::timerEvent(ev);
+		return;
+	}
+	m_timerWheel.advance(QDynamicEventsTimerWheel::elapsedMs());
+	// do not wake up the thread when there is nothing to do
+	if (m_timerWheel.isEmpty())
+	{
+		this->killTimer(m_wheelTimerId);
+		m_wheelTimerId = 0;
+	}
+}
+
+int QDynamicEventsProxyObject::laneForPriority(int priority)
+{
+	// NOTE : lanes are High, Normal and Low, any custom priority goes to the nearest one
+	if (priority > Qt::NormalEventPriority)
+	{
+		return 0;
+	}
+	if (priority < Qt::NormalEventPriority)
+	{
+		return 2;
+	}
+	return 1;
+}
+
+QDynamicEventsTimerWheel::QDynamicEventsTimerWheel(int bucketCount/* = 256*/, int tickMs/* = 1*/) :
+	m_buckets(qMax(1, bucketCount)),
+	m_currTick(-1),
+	m_count(0),
+	m_tickMs(qMax(1, tickMs))
+{
+	// nothing to do here
+}
+
+void QDynamicEventsTimerWheel::schedule(qint64 nowMs, qint64 deadlineMs, std::function<void()> func)
+{
+	// start counting from now if idle
+	if (m_count == 0)
+	{
+		m_currTick = nowMs / m_tickMs;
+	}
+	// NOTE : never in the current bucket, it was already processed
+	qint64 tick = qMax(deadlineMs / m_tickMs, m_currTick + 1);
+	Entry entry;
+	entry.deadlineMs = deadlineMs;
+	entry.func       = func;
+	m_buckets[tick % m_buckets.count()].append(entry);
+	m_count++;
+}
+
+void QDynamicEventsTimerWheel::advance(qint64 nowMs)
+{
+	qint64 nowTick = nowMs / m_tickMs;
+	if (m_count == 0 || nowTick <= m_currTick)
+	{
+		return;
+	}
+	// visit buckets of elapsed ticks, no need to visit a bucket more than once
+	qint64 firstTick = qMax(m_currTick + 1, nowTick - m_buckets.count() + 1);
+	m_currTick = nowTick;
+	QList<std::function<void()>> listExpired;
+	for (qint64 tick = firstTick; tick <= nowTick; tick++)
+	{
+		auto &listEntries = m_buckets[tick % m_buckets.count()];
+		for (int i = 0; i < listEntries.count();)
+		{
+			// entries with deadline in a later turn stay
+			if (listEntries.at(i).deadlineMs > nowMs)
+			{
+				i++;
+				continue;
+			}
+			listExpired.append(listEntries.takeAt(i).func);
+			m_count--;
+		}
+	}
+	// NOTE : call after updating the buckets, functions are allowed to schedule again
+	for (int i = 0; i < listExpired.count(); i++)
+	{
+		listExpired[i]();
+	}
+}
+
+bool QDynamicEventsTimerWheel::isEmpty() const
+{
+	return m_count == 0;
+}
+
+int QDynamicEventsTimerWheel::tickMs() const
+{
+	return m_tickMs;
+}
+
+qint64 QDynamicEventsTimerWheel::elapsedMs()
+{
+	// NOTE : thread safe initialization since c++11
+	static QElapsedTimer s_timer = []() {
+		QElapsedTimer timer;
+		timer.start();
+		return timer;
+	}();
+	return s_timer.elapsed();
+}
+
+QDynamicEventsRate::QDynamicEventsRate(Mode mode/* = None*/, int value/* = 0*/) :
+	mode(mode),
+	value(value)
+{
+	// nothing to do here
+}
+
+QDynamicEventsRate QDynamicEventsRate::throttle(int intervalMs)
+{
+	return QDynamicEventsRate(QDynamicEventsRate::Throttle, intervalMs);
+}
+
+QDynamicEventsRate QDynamicEventsRate::debounce(int intervalMs)
+{
+	return QDynamicEventsRate(QDynamicEventsRate::Debounce, intervalMs);
+}
+
+QDynamicEventsRate QDynamicEventsRate::sample(int everyN)
+{
+	return QDynamicEventsRate(QDynamicEventsRate::Sample, everyN);
+}
+
 QDynamicEventsProxyEvent::QDynamicEventsProxyEvent() : QEvent(QDYNAMICEVENTSPROXY_EVENT_TYPE)
 {
 	// nothing to do here
@@ -25,7 +190,7 @@ QDynamicEventsProxyEvent::QDynamicEventsProxyEvent() : QEvent(QDYNAMICEVENTSPROX
 // define static members and methods of base class
 QMutex                                         QDynamicEventsDataBase::s_mutex;
 QMap< QThread *, QDynamicEventsProxyObject * > QDynamicEventsDataBase::s_threadMap;
-qlonglong                                      QDynamicEventsDataBase::s_funcId = 0;
+QAtomicInteger<qlonglong>                      QDynamicEventsDataBase::s_funcId(0);
 
 QDynamicEventsProxyObject * QDynamicEventsDataBase::getObjectForThread(QThread * p_currThd)
 {
@@ -48,9 +213,223 @@ QDynamicEventsProxyObject * QDynamicEventsDataBase::getObjectForThread(QThread *
 	return s_threadMap[p_currThd];
 }
 
-QDynamicEventsHandle::QDynamicEventsHandle(QString strEventName, QThread * p_handleThread, qlonglong funcId)
+QList<QDynamicEventsLaneMetrics> QDynamicEventsDataBase::laneMetrics(QThread * p_thread)
+{
+	QMutexLocker locker(&QDynamicEventsDataBase::s_mutex);
+	// do not create a proxy object just to read metrics
+	if (!s_threadMap.contains(p_thread))
+	{
+		return QList<QDynamicEventsLaneMetrics>();
+	}
+	return s_threadMap[p_thread]->laneMetrics();
+}
+
+QStringList QDynamicEventsDataBase::splitEventNames(const QString &strEventNames)
+{
+	QStringList listEventNames;
+	int start = -1;
+	for (int i = 0; i <= strEventNames.size(); i++)
+	{
+		if (i < strEventNames.size() && !strEventNames.at(i).isSpace())
+		{
+			// start of name
+			if (start < 0)
+			{
+				start = i;
+			}
+			continue;
+		}
+		// end of name
+		if (start >= 0)
+		{
+			listEventNames.append(strEventNames.mid(start, i - start));
+			start = -1;
+		}
+	}
+	return listEventNames;
+}
+
+QDynamicEventsHandle::QDynamicEventsHandle(QString strEventName, QThread * p_handleThread, qlonglong funcId, int slot)
 {
 	m_strEventName  = strEventName;
 	mp_handleThread = p_handleThread;
 	m_funcId        = funcId;
+	m_slot          = slot;
+	m_eventerIndex  = -1;
+}
+
+QDynamicEventsTopicTrie::QDynamicEventsTopicTrie() :
+	mp_root(nullptr),
+	m_dirty(false)
+{
+	// nothing to do here
+}
+
+QDynamicEventsTopicTrie::QDynamicEventsTopicTrie(const QDynamicEventsTopicTrie &other) :
+	mp_root(nullptr),
+	m_listPatterns(other.m_listPatterns),
+	m_dirty(true)
+{
+	// nodes are not shared, compile again on next match
+}
+
+QDynamicEventsTopicTrie & QDynamicEventsTopicTrie::operator=(const QDynamicEventsTopicTrie &rhs)
+{
+	if (this != &rhs) {
+		this->clear();
+		m_listPatterns = rhs.m_listPatterns;
+		m_dirty        = true;
+	}
+	return *this;
+}
+
+QDynamicEventsTopicTrie::~QDynamicEventsTopicTrie()
+{
+	QDynamicEventsTopicTrie::deleteNode(mp_root);
+}
+
+bool QDynamicEventsTopicTrie::isPattern(const QString &strEventName)
+{
+	// fast path, most event names are not patterns
+	if (!strEventName.contains('*') && !strEventName.contains('#'))
+	{
+		return false;
+	}
+	QStringList listLevels = strEventName.split('.');
+	return listLevels.contains("*") || listLevels.last() == "#";
+}
+
+void QDynamicEventsTopicTrie::addPattern(const QString &strPattern)
+{
+	if (m_listPatterns.contains(strPattern))
+	{
+		return;
+	}
+	m_listPatterns.append(strPattern);
+	m_dirty = true;
+}
+
+void QDynamicEventsTopicTrie::removePattern(const QString &strPattern)
+{
+	if (m_listPatterns.removeAll(strPattern) == 0)
+	{
+		return;
+	}
+	m_dirty = true;
+}
+
+QStringList QDynamicEventsTopicTrie::patterns() const
+{
+	return m_listPatterns;
+}
+
+void QDynamicEventsTopicTrie::clear()
+{
+	QDynamicEventsTopicTrie::deleteNode(mp_root);
+	mp_root = nullptr;
+	m_listPatterns.clear();
+	m_matchCache.clear();
+	m_dirty = false;
+}
+
+bool QDynamicEventsTopicTrie::isEmpty() const
+{
+	return m_listPatterns.isEmpty();
+}
+
+QStringList QDynamicEventsTopicTrie::match(const QString &strTopic)
+{
+	if (m_dirty)
+	{
+		this->compile();
+	}
+	// same topics are usually triggered over and over
+	auto it = m_matchCache.constFind(strTopic);
+	if (it != m_matchCache.constEnd())
+	{
+		return it.value();
+	}
+	QStringList listMatches;
+	this->matchInternal(mp_root, strTopic.split('.'), 0, listMatches);
+	// keep cache bounded, topics might be generated dynamically
+	if (m_matchCache.count() >= 4096)
+	{
+		m_matchCache.clear();
+	}
+	m_matchCache.insert(strTopic, listMatches);
+	return listMatches;
+}
+
+void QDynamicEventsTopicTrie::compile()
+{
+	QDynamicEventsTopicTrie::deleteNode(mp_root);
+	mp_root = new Node{ QHash<QString, Node *>(), nullptr, nullptr, QStringList() };
+	for (int i = 0; i < m_listPatterns.count(); i++)
+	{
+		QStringList listLevels = m_listPatterns[i].split('.');
+		Node * p_node = mp_root;
+		for (int j = 0; j < listLevels.count(); j++)
+		{
+			auto &strLevel = listLevels[j];
+			Node ** pp_next;
+			if (strLevel == "*")
+			{
+				pp_next = &p_node->p_star;
+			}
+			else if (strLevel == "#" && j == listLevels.count() - 1)
+			{
+				pp_next = &p_node->p_hash;
+			}
+			else
+			{
+				pp_next = &p_node->children[strLevel];
+			}
+			if (!*pp_next)
+			{
+				*pp_next = new Node{ QHash<QString, Node *>(), nullptr, nullptr, QStringList() };
+			}
+			p_node = *pp_next;
+		}
+		p_node->patterns.append(m_listPatterns[i]);
+	}
+	m_matchCache.clear();
+	m_dirty = false;
+}
+
+void QDynamicEventsTopicTrie::matchInternal(Node * p_node, const QStringList &listLevels, int index, QStringList &listMatches)
+{
+	// trailing '#' matches whatever is left
+	if (p_node->p_hash)
+	{
+		listMatches.append(p_node->p_hash->patterns);
+	}
+	if (index == listLevels.count())
+	{
+		listMatches.append(p_node->patterns);
+		return;
+	}
+	auto itChild = p_node->children.constFind(listLevels[index]);
+	if (itChild != p_node->children.constEnd())
+	{
+		this->matchInternal(itChild.value(), listLevels, index + 1, listMatches);
+	}
+	if (p_node->p_star)
+	{
+		this->matchInternal(p_node->p_star, listLevels, index + 1, listMatches);
+	}
+}
+
+void QDynamicEventsTopicTrie::deleteNode(Node * p_node)
+{
+	if (!p_node)
+	{
+		return;
+	}
+	for (auto p_child : p_node->children)
+	{
+		QDynamicEventsTopicTrie::deleteNode(p_child);
+	}
+	QDynamicEventsTopicTrie::deleteNode(p_node->p_star);
+	QDynamicEventsTopicTrie::deleteNode(p_node->p_hash);
+	delete p_node;
 }
@@ -8,9 +8,65 @@
 #include <QThread>
 #include <QMutex>
 #include <QMap>
+#include <QHash>
+#include <QStringList>
+#include <QAtomicInteger>
+#include <QSharedPointer>
+#include <QVector>
+#include <QElapsedTimer>
 #include <functional>
 
+#include "qeventmailbox.hpp"
+
 #define QDYNAMICEVENTSPROXY_EVENT_TYPE (QEvent::Type)(QEvent::User + 666)
+// wakeup event of the mailbox used to queue the callbacks for each thread
+#define QDYNAMICEVENTSPROXY_MAILBOX_EVENT_TYPE (QEvent::Type)(QEvent::User + 667)
+// max number of callbacks executed in a row from a lane while lower lanes are waiting
+#define QDYNAMICEVENTSPROXY_MAX_STREAK 16
+
+// queue metrics of a delivery lane of a thread
+struct QDynamicEventsLaneMetrics
+{
+	// lowest priority delivered through this lane (High, Normal or Low)
+	Qt::EventPriority priority;
+	// callbacks currently waiting to be executed
+	int               depth;
+	// maximum number of callbacks ever waiting at the same time
+	int               maxDepth;
+};
+
+// hashed timer wheel, used to deliver the trailing events of rate limited subscriptions
+// NOTE : * not thread safe, only used in the thread of the proxy object owning it
+//        * entries are placed in the bucket of their deadline tick, entries further than one
+//          turn away stay in their bucket until their deadline is reached
+class QDynamicEventsTimerWheel
+{
+public:
+	explicit QDynamicEventsTimerWheel(int bucketCount = 256, int tickMs = 1);
+
+	// call function once deadline is reached
+	void schedule(qint64 nowMs, qint64 deadlineMs, std::function<void()> func);
+	// call all functions with a deadline up to now
+	void advance(qint64 nowMs);
+	// no functions scheduled
+	bool isEmpty() const;
+	// resolution
+	int  tickMs() const;
+
+	// monotonic time shared by all wheels and rate limited subscriptions
+	static qint64 elapsedMs();
+
+private:
+	struct Entry
+	{
+		qint64                deadlineMs;
+		std::function<void()> func;
+	};
+	QVector<QList<Entry>> m_buckets;
+	qint64                m_currTick;
+	int                   m_count;
+	int                   m_tickMs;
+};
 
 class QDynamicEventsProxyObject : public QObject
 {
@@ -20,8 +76,35 @@ public:
 
 	bool event(QEvent* ev);
 
+	// queue function to be executed in the thread of this object, in the lane matching the priority
+	template<typename F>
+	void post(F &&func, int priority = Qt::NormalEventPriority);
+
+	// metrics of each lane, highest priority first
+	QList<QDynamicEventsLaneMetrics> laneMetrics() const;
+
+	// call function in the thread of this object once deadline is reached (can be called from any thread)
+	void schedule(qint64 deadlineMs, std::function<void()> func);
+
+	// lane used for a priority
+	static int laneForPriority(int priority);
+
+protected:
+	void timerEvent(QTimerEvent * ev);
+
+private:
+	QEventMailbox            m_mailbox;
+	QDynamicEventsTimerWheel m_timerWheel;
+	// timer driving the wheel, only running while there is something scheduled
+	int                      m_wheelTimerId;
 };
 
+template<typename F>
+void QDynamicEventsProxyObject::post(F &&func, int priority/* = Qt::NormalEventPriority*/)
+{
+	m_mailbox.post(std::forward<F>(func), QDynamicEventsProxyObject::laneForPriority(priority));
+}
+
 class QDynamicEventsProxyEvent : public QEvent
 {
 public:
@@ -31,14 +114,94 @@ public:
 
 };
 
+// compiled trie of wildcard event names, topic levels are separated by '.'
+// '*' matches exactly one level, a trailing '#' matches any number of levels (including none)
+// e.g. "sensor.*" matches "sensor.temp", "sensor.temp.#" matches "sensor.temp" and "sensor.temp.zone3"
+class QDynamicEventsTopicTrie
+{
+public:
+	QDynamicEventsTopicTrie();
+	QDynamicEventsTopicTrie(const QDynamicEventsTopicTrie &other);
+	QDynamicEventsTopicTrie &operator=(const QDynamicEventsTopicTrie &rhs);
+	~QDynamicEventsTopicTrie();
+
+	// check if event name contains wildcards
+	static bool isPattern(const QString &strEventName);
+	// add pattern (trie gets recompiled lazily on next match)
+	void addPattern(const QString &strPattern);
+	// remove pattern
+	void removePattern(const QString &strPattern);
+	// list of patterns added
+	QStringList patterns() const;
+	// remove all patterns
+	void clear();
+	// no patterns added
+	bool isEmpty() const;
+	// get all the patterns matching a topic, cached by topic
+	QStringList match(const QString &strTopic);
+
+private:
+	struct Node
+	{
+		QHash<QString, Node *> children;
+		Node *                 p_star;
+		Node *                 p_hash;
+		QStringList            patterns;
+	};
+	Node *                      mp_root;
+	QStringList                 m_listPatterns;
+	QHash<QString, QStringList> m_matchCache;
+	bool                        m_dirty;
+	// rebuild trie from the patterns list
+	void compile();
+	void matchInternal(Node * p_node, const QStringList &listLevels, int index, QStringList &listMatches);
+	static void deleteNode(Node * p_node);
+};
+
+// rate limiting options of a subscription, enforced when triggering so dropped events are never queued
+// * throttle : at most one call every interval, the last args of the interval are delivered when it ends
+// * debounce : one call once no trigger happened for an interval, with the last args
+// NOTE : trailing calls (throttle end, debounce) are queued in the subscription's thread with the priority of the
+//        last dropped trigger, except for Qt::DirectConnection where they are called as soon as the interval ends
+// * sample   : one call every N triggers
+class QDynamicEventsRate
+{
+public:
+	enum Mode
+	{
+		None,
+		Throttle,
+		Debounce,
+		Sample
+	};
+	QDynamicEventsRate(Mode mode = None, int value = 0);
+
+	static QDynamicEventsRate throttle(int intervalMs);
+	static QDynamicEventsRate debounce(int intervalMs);
+	static QDynamicEventsRate sample(int everyN);
+
+	Mode mode;
+	// interval in milliseconds, or N for sample
+	int  value;
+};
+
 // have all template classes derive from common base class which to contains the static members
 class QDynamicEventsDataBase {
 
+public:
+	// delivery lanes metrics of a thread (empty if no callbacks were ever subscribed in that thread)
+	static QList<QDynamicEventsLaneMetrics> laneMetrics(QThread * p_thread);
+	// split space separated event names
+	// NOTE : hand written instead of a regex split, a single event name is returned without any copy
+	static QStringList splitEventNames(const QString &strEventNames);
+
 protected:
 	static QDynamicEventsProxyObject * getObjectForThread(QThread * p_currThd);
 	static QMap< QThread *, QDynamicEventsProxyObject * > s_threadMap;
 	static QMutex    s_mutex;
-	static qlonglong s_funcId;
+	// NOTE : ids are unique across all QDynamicEventsData instances, so they double as the
+	//        generation of a callback slot and a handle can never match a slot it does not own
+	static QAtomicInteger<qlonglong> s_funcId;
 };
 
 // forward declaration to be able to make friend
@@ -48,15 +211,19 @@ class QDynamicEventsData;
 class QDynamicEventsHandle
 {
 public:
-	QDynamicEventsHandle(QString strEventName = QString(), QThread * p_handleThread = nullptr, qlonglong funcId = -1);
+	QDynamicEventsHandle(QString strEventName = QString(), QThread * p_handleThread = nullptr, qlonglong funcId = -1, int slot = -1);
 private:
 	// make friend, so it can access internal methods
 	template<class ...Types>
 	friend class QDynamicEventsData;
+	friend class QEventer;
 
 	QString   m_strEventName ;
 	QThread * mp_handleThread;
 	qlonglong m_funcId;
+	int       m_slot;
+	// index of the QEventer typed eventer the handle belongs to, -1 if not created by a QEventer
+	int       m_eventerIndex;
 };
 
 // forward declaration to be able to pass as arg
@@ -75,9 +242,9 @@ public:
 	// consumer API
 
 	// on method	
-	QDynamicEventsHandle on(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection);
+	QDynamicEventsHandle on(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection, Qt::EventPriority priority = Qt::NormalEventPriority, QDynamicEventsRate rate = QDynamicEventsRate());
 	// once method	
-	QDynamicEventsHandle once(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection);
+	QDynamicEventsHandle once(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection, Qt::EventPriority priority = Qt::NormalEventPriority);
 	// off method (all callbacks registered to an specific event name)
 	void off(QString strEventName);
 	// off method (specific callback based on handle)
@@ -85,27 +252,70 @@ public:
 	// off method (all callbacks)
 	void off();
 
+	// retained API
+
+	// enable or disable retained mode, last triggered args are delivered to callbacks subscribed later
+	void setRetained(QString strEventName, bool retained = true);
+	// check if retained mode is enabled
+	bool isRetained(QString strEventName);
+	// forget last triggered args, retained mode stays enabled
+	void clearRetained(QString strEventName);
+
 	// provider API
 
 	void trigger(QDynamicEvents<Types...> ref, QString strEventName, Types(&...args));
+	// NOTE : queued callbacks are delivered with the highest of the trigger and the subscription priorities
+	void trigger(QDynamicEvents<Types...> ref, const Qt::EventPriority &priority, QString strEventName, Types(&...args));
 
 private:
 	// thread safety first
 	QMutex m_mutex;
 	// list of connections to avoid memory leaks
 	QList<QMetaObject::Connection> m_connectionList;
+	// trigger args bound to a function, to call a callback with them later
+	typedef std::function<void(std::function<void(Types(&...args))>)> BoundArgsFunction;
 	// struct to store callback data
 	struct CallbackData
 	{
 		std::function<void(Types(&...args))> callback;
 		std::function<bool(Types(&...args))> filter;
 		Qt::ConnectionType                   connection;
+		Qt::EventPriority                    priority;
+		// rate limiting state (only on subscriptions)
+		QDynamicEventsRate                   rate;
+		// time of last call
+		qint64                               rateLastMs;
+		// end of debounce interval
+		qint64                               rateDeadlineMs;
+		// triggers since last sample
+		int                                  rateCount;
+		// timer scheduled to deliver pending args
+		bool                                 rateScheduled;
+		// args of last dropped trigger, delivered when timer expires
+		BoundArgsFunction                    ratePending;
+		// priority of last dropped trigger
+		Qt::EventPriority                    ratePriority;
+		// generation of the slot (id of the function using it), -1 if the slot is free
+		qlonglong                            funcId;
+		// number of map entries (event names) still pointing to this slot
+		int                                  refCount;
 	};
+	// callback slots, indexed directly by the handles so off(handle) does not need to walk the maps
+	// NOTE : QList stores large items on the heap, so references remain valid while appending
+	QList<CallbackData> m_slots;
+	QList<int>          m_freeSlots;
+	// map entries pointing to invalidated slots, purged lazily
+	int                 m_staleCount;
+	// last args of the retained event names, bound once in an immutable function shared by all late subscribers
+	// NOTE : event name present with a null value means retained mode is enabled but it was not triggered yet
+	QHash<QString, QSharedPointer<const BoundArgsFunction>> m_retainedMap;
+	// wildcard event names subscribed to, their callbacks are stored in the maps below by pattern
+	QDynamicEventsTopicTrie m_topicTrie;
 	// map of maps of maps, multiple callbacks by:
 	QMap< QString,      // by event name
 		QMap< QThread *,  // by thread
 			QMap< qlonglong, // an identifier for the function
-				  CallbackData
+				  int        // the slot containing the callback data
 				> 
 			> 
 		> m_callbacksMap;
@@ -113,27 +323,51 @@ private:
 	QMap< QString,      // by event name
 		QMap< QThread *,  // by thread
 			QMap< qlonglong, // an identifier for the function
-		          CallbackData
+		          int        // the slot containing the callback data
 				>
 			>
 		> m_callbacksMapOnce;
 	// create proxy object for unknown thread
 	void createProxyObj(QString &strEventName);
+	// get a free slot and fill it with the callback data
+	int  acquireSlot(qlonglong &funcId, std::function<void(Types(&...args))> &callback, std::function<bool(Types(&...args))> &filter, Qt::ConnectionType &connection, Qt::EventPriority &priority);
+	// check slot still belongs to the given function
+	bool isSlotValid(const int &slot, const qlonglong &funcId);
+	// drop one map entry reference to a slot, free the slot when no entries are left
+	void releaseSlotRef(const int &slot, const qlonglong &funcId);
+	// mark slot as free, to be reused by later subscriptions
+	void freeSlot(const int &slot);
+	// remove all map entries pointing to invalidated slots
+	void purgeStaleInternal();
+	// check if there is any callback left for an event name
+	bool hasCallbacksInternal(const QString &strEventName);
 	// internal on
-	void onInternal(QString &strEventName, qlonglong &funcId, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection);
+	void onInternal(QString &strEventName, qlonglong &funcId, int &slot);
 	// internal once
-	void onceInternal(QString &strEventName, qlonglong &funcId, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection);
+	void onceInternal(QString &strEventName, qlonglong &funcId, int &slot);
 	// off method (all callbacks registered to an specific event name)
 	void offInternal(QString &strEventName);
-	// off method (specific callback based on handle)
-	void offInternal(QString &strEventName, QThread *pThread, qlonglong &funcId);
+	// off method (all callbacks of an event name registered in a specific thread)
+	void offInternal(QString &strEventName, QThread *pThread);
+	// call new callback with retained args of the event names it subscribed to, returns true if called
+	bool deliverRetainedInternal(QStringList &listEventNames, const int &slot, const bool &isOnce);
+	// check rate limit of a subscription, returns true if the callback must be called now
+	// NOTE : otherwise args are kept to be delivered by the timer wheel of the subscription's thread
+	bool rateAllowInternal(QDynamicEvents<Types...> &ref, const Qt::EventPriority &priority, const int &slot, const qlonglong &funcId, QThread * p_thread, Types(&...args));
+	// schedule delivery of pending args in the timer wheel of the subscription's thread
+	void rateScheduleInternal(QDynamicEvents<Types...> &ref, const int &slot, const qlonglong &funcId, QThread * p_thread, const qint64 &deadlineMs);
+	// timer wheel expired, runs in the subscription's thread and queues the pending call (unless direct)
+	void rateTimeout(QDynamicEvents<Types...> ref, int slot, qlonglong funcId);
+	// call function with retained args
+	static void retainedFunctionTemplate(std::function<void(Types(&...args))> callback, Types(&...args));
 	// internal trigger
-	void triggerInternal(QDynamicEvents<Types...> ref, QString &strEventName, Types(&...args));
+	void triggerInternal(QDynamicEvents<Types...> ref, const Qt::EventPriority &priority, QString &strEventName, Types(&...args));
 };
 
 template<class ...Types>
 QDynamicEventsData<Types...>::QDynamicEventsData()
-	: m_mutex(QMutex::Recursive)
+	: m_mutex(QMutex::Recursive),
+	m_staleCount(0)
 {
 	// nothing to do here
 }
@@ -142,6 +376,11 @@ template<class ...Types>
 QDynamicEventsData<Types...>::QDynamicEventsData(const QDynamicEventsData &other) : QSharedData(other),
 m_mutex(other.m_mutex),
 m_connectionList(other.m_connectionList),
+m_slots(other.m_slots),
+m_freeSlots(other.m_freeSlots),
+m_staleCount(other.m_staleCount),
+m_retainedMap(other.m_retainedMap),
+m_topicTrie(other.m_topicTrie),
 m_callbacksMap(other.m_callbacksMap)
 {
 	// nothing to do here
@@ -158,6 +397,8 @@ QDynamicEventsData<Types...>::~QDynamicEventsData()
 	}
 	m_callbacksMap.clear();
 	m_callbacksMapOnce.clear();
+	m_slots.clear();
+	m_freeSlots.clear();
 }
 
 template<class ...Types>
@@ -165,7 +406,7 @@ void QDynamicEventsData<Types...>::off(QString strEventName)
 {
 	QMutexLocker locker(&m_mutex);
 	// split by spaces
-	QStringList listEventNames = strEventName.split(QRegExp("\\s+"), QString::SkipEmptyParts);
+	QStringList listEventNames = QDynamicEventsDataBase::splitEventNames(strEventName);
 	// for each event name
 	for (int i = 0; i < listEventNames.count(); i++)
 	{
@@ -177,38 +418,441 @@ template<class ...Types>
 void QDynamicEventsData<Types...>::offInternal(QString &strEventName)
 {
 	// remove for all threads and all callbacks
+	auto listThreads = m_callbacksMap.value(strEventName).keys();
+	for (int i = 0; i < listThreads.count(); i++)
+	{
+		offInternal(strEventName, listThreads[i]);
+	}
+	auto listThreadsOnce = m_callbacksMapOnce.value(strEventName).keys();
+	for (int i = 0; i < listThreadsOnce.count(); i++)
+	{
+		offInternal(strEventName, listThreadsOnce[i]);
+	}
 	m_callbacksMap.remove(strEventName);
 	m_callbacksMapOnce.remove(strEventName);
+	if (QDynamicEventsTopicTrie::isPattern(strEventName))
+	{
+		m_topicTrie.removePattern(strEventName);
+	}
+}
+
+template<class ...Types>
+void QDynamicEventsData<Types...>::offInternal(QString &strEventName, QThread *pThread)
+{
+	// [NOTE] No lock in internal methods
+	auto mapOnlyCallbacks = m_callbacksMap[strEventName].take(pThread);
+	for (auto it = mapOnlyCallbacks.constBegin(); it != mapOnlyCallbacks.constEnd(); ++it)
+	{
+		this->releaseSlotRef(it.value(), it.key());
+	}
+	auto mapOnlyCallbacksOnce = m_callbacksMapOnce[strEventName].take(pThread);
+	for (auto it = mapOnlyCallbacksOnce.constBegin(); it != mapOnlyCallbacksOnce.constEnd(); ++it)
+	{
+		this->releaseSlotRef(it.value(), it.key());
+	}
 }
 
 template<class ...Types>
 void QDynamicEventsData<Types...>::off(QDynamicEventsHandle evtHandle)
+{
+	QMutexLocker locker(&m_mutex);
+	// handle belongs to another eventer or was already removed
+	if (!this->isSlotValid(evtHandle.m_slot, evtHandle.m_funcId))
+	{
+		return;
+	}
+	// invalidate slot directly, entries left in the maps are purged lazily
+	m_staleCount += m_slots[evtHandle.m_slot].refCount;
+	this->freeSlot(evtHandle.m_slot);
+	// purge once stale entries outnumber the slots, to keep the maps from growing on subscription churn
+	if (m_staleCount > m_slots.count())
+	{
+		this->purgeStaleInternal();
+	}
+}
+
+template<class ...Types>
+void QDynamicEventsData<Types...>::off()
+{
+	QMutexLocker locker(&m_mutex);
+	// remove all callbacks
+	m_callbacksMap.clear();
+	m_callbacksMapOnce.clear();
+	m_slots.clear();
+	m_freeSlots.clear();
+	m_staleCount = 0;
+	m_topicTrie.clear();
+}
+
+template<class ...Types>
+void QDynamicEventsData<Types...>::setRetained(QString strEventName, bool retained/* = true*/)
 {
 	QMutexLocker locker(&m_mutex);
 	// split by spaces
-	QStringList listEventNames = evtHandle.m_strEventName.split(QRegExp("\\s+"), QString::SkipEmptyParts);
+	QStringList listEventNames = QDynamicEventsDataBase::splitEventNames(strEventName);
 	// for each event name
 	for (int i = 0; i < listEventNames.count(); i++)
 	{
-		offInternal(listEventNames[i], evtHandle.mp_handleThread, evtHandle.m_funcId);
+		// NOTE : wildcards are allowed when subscribing, but retained values are stored by triggered event name
+		Q_ASSERT_X(!QDynamicEventsTopicTrie::isPattern(listEventNames[i]), "QDynamicEventsData<Types...>::setRetained", "Retained event name cannot be a pattern.");
+		if (!retained)
+		{
+			m_retainedMap.remove(listEventNames[i]);
+		}
+		else if (!m_retainedMap.contains(listEventNames[i]))
+		{
+			m_retainedMap.insert(listEventNames[i], QSharedPointer<const BoundArgsFunction>());
+		}
 	}
 }
 
 template<class ...Types>
-void QDynamicEventsData<Types...>::offInternal(QString &strEventName, QThread *pThread, qlonglong &funcId)
+bool QDynamicEventsData<Types...>::isRetained(QString strEventName)
 {
-	// remove very specific callback
-	m_callbacksMap[strEventName][pThread].remove(funcId);
-	m_callbacksMapOnce[strEventName][pThread].remove(funcId);
+	QMutexLocker locker(&m_mutex);
+	return m_retainedMap.contains(strEventName);
 }
 
 template<class ...Types>
-void QDynamicEventsData<Types...>::off()
+void QDynamicEventsData<Types...>::clearRetained(QString strEventName)
 {
 	QMutexLocker locker(&m_mutex);
-	// remove all callbacks
-	m_callbacksMap.clear();
-	m_callbacksMapOnce.clear();
+	// split by spaces
+	QStringList listEventNames = QDynamicEventsDataBase::splitEventNames(strEventName);
+	// for each event name
+	for (int i = 0; i < listEventNames.count(); i++)
+	{
+		if (m_retainedMap.contains(listEventNames[i]))
+		{
+			m_retainedMap[listEventNames[i]].clear();
+		}
+	}
+}
+
+template<class ...Types>
+bool QDynamicEventsData<Types...>::deliverRetainedInternal(QStringList &listEventNames, const int &slot, const bool &isOnce)
+{
+	// [NOTE] No lock in internal methods
+	// collect retained values of the subscribed event names (wildcards collect all matching event names)
+	QList<QSharedPointer<const BoundArgsFunction>> listValues;
+	for (int i = 0; i < listEventNames.count(); i++)
+	{
+		if (!QDynamicEventsTopicTrie::isPattern(listEventNames[i]))
+		{
+			auto p_value = m_retainedMap.value(listEventNames[i]);
+			if (p_value)
+			{
+				listValues.append(p_value);
+			}
+			continue;
+		}
+		QDynamicEventsTopicTrie topicTrie;
+		topicTrie.addPattern(listEventNames[i]);
+		for (auto it = m_retainedMap.constBegin(); it != m_retainedMap.constEnd(); ++it)
+		{
+			if (it.value() && !topicTrie.match(it.key()).isEmpty())
+			{
+				listValues.append(it.value());
+			}
+		}
+	}
+	// NOTE : copy callback data, a direct callback might call off(handle) and release the slot
+	auto currCallbackData = m_slots.at(slot);
+	bool delivered        = false;
+	for (int i = 0; i < listValues.count(); i++)
+	{
+		auto p_value = listValues.at(i);
+		// skip filtered
+		bool passed = true;
+		if (currCallbackData.filter)
+		{
+			(*p_value)([&passed, &currCallbackData](Types(&...args)) {
+				passed = currCallbackData.filter(args...);
+			});
+		}
+		if (!passed)
+		{
+			continue;
+		}
+		// subscriber is always in the current thread, so auto connection means direct
+		if (currCallbackData.connection == Qt::DirectConnection || currCallbackData.connection == Qt::AutoConnection)
+		{
+			// call directly
+			(*p_value)(currCallbackData.callback);
+		}
+		else if (currCallbackData.connection == Qt::QueuedConnection)
+		{
+			auto p_currObject = QDynamicEventsDataBase::getObjectForThread(QThread::currentThread());
+			auto currCallback = currCallbackData.callback;
+			// NOTE : shared value is not copied, only its reference count increased
+			p_currObject->post([p_value, currCallback]() {
+				(*p_value)(currCallback);
+			}, currCallbackData.priority);
+		}
+		else
+		{
+			Q_ASSERT_X(false, "QDynamicEventsData<Types...>::deliverRetainedInternal", "Unsupported connection type.");
+		}
+		delivered = true;
+		if (isOnce)
+		{
+			break;
+		}
+	}
+	return delivered;
+}
+
+template<class ...Types>
+bool QDynamicEventsData<Types...>::rateAllowInternal(QDynamicEvents<Types...> &ref, const Qt::EventPriority &priority, const int &slot, const qlonglong &funcId, QThread * p_thread, Types(&...args))
+{
+	// [NOTE] No lock in internal methods
+	auto &currCallbackData = m_slots[slot];
+	auto &rate             = currCallbackData.rate;
+	switch (rate.mode)
+	{
+	case QDynamicEventsRate::Sample:
+	{
+		if (++currCallbackData.rateCount < rate.value)
+		{
+			return false;
+		}
+		currCallbackData.rateCount = 0;
+		return true;
+	}
+	case QDynamicEventsRate::Throttle:
+	{
+		qint64 nowMs = QDynamicEventsTimerWheel::elapsedMs();
+		// leading call
+		if (!currCallbackData.rateScheduled && (currCallbackData.rateLastMs < 0 || nowMs - currCallbackData.rateLastMs >= rate.value))
+		{
+			currCallbackData.rateLastMs = nowMs;
+			return true;
+		}
+		// keep last args, delivered when the interval ends
+		currCallbackData.ratePending  = std::bind(&QDynamicEventsData<Types...>::retainedFunctionTemplate, std::placeholders::_1, args...);
+		currCallbackData.ratePriority = qMax(priority, currCallbackData.priority);
+		if (!currCallbackData.rateScheduled)
+		{
+			currCallbackData.rateScheduled = true;
+			this->rateScheduleInternal(ref, slot, funcId, p_thread, currCallbackData.rateLastMs + rate.value);
+		}
+		return false;
+	}
+	case QDynamicEventsRate::Debounce:
+	{
+		// keep last args, delivered once triggers stop for an interval
+		currCallbackData.ratePending    = std::bind(&QDynamicEventsData<Types...>::retainedFunctionTemplate, std::placeholders::_1, args...);
+		currCallbackData.ratePriority   = qMax(priority, currCallbackData.priority);
+		currCallbackData.rateDeadlineMs = QDynamicEventsTimerWheel::elapsedMs() + rate.value;
+		// NOTE : an already scheduled timer is not moved, it reschedules itself when it expires too early
+		if (!currCallbackData.rateScheduled)
+		{
+			currCallbackData.rateScheduled = true;
+			this->rateScheduleInternal(ref, slot, funcId, p_thread, currCallbackData.rateDeadlineMs);
+		}
+		return false;
+	}
+	default:
+		return true;
+	}
+}
+
+template<class ...Types>
+void QDynamicEventsData<Types...>::rateScheduleInternal(QDynamicEvents<Types...> &ref, const int &slot, const qlonglong &funcId, QThread * p_thread, const qint64 &deadlineMs)
+{
+	// [NOTE] No lock in internal methods
+	auto p_currObject = QDynamicEventsDataBase::getObjectForThread(p_thread);
+	// NOTE : keep a reference until the timer expires
+	p_currObject->schedule(deadlineMs, [this, ref, slot, funcId]() {
+		this->rateTimeout(ref, slot, funcId);
+	});
+}
+
+template<class ...Types>
+void QDynamicEventsData<Types...>::rateTimeout(QDynamicEvents<Types...> ref, int slot, qlonglong funcId)
+{
+	QMutexLocker locker(&m_mutex);
+	// subscription removed meanwhile
+	if (!this->isSlotValid(slot, funcId))
+	{
+		return;
+	}
+	auto &currCallbackData = m_slots[slot];
+	qint64 nowMs = QDynamicEventsTimerWheel::elapsedMs();
+	// debounce got triggered again meanwhile
+	if (currCallbackData.rate.mode == QDynamicEventsRate::Debounce && nowMs < currCallbackData.rateDeadlineMs)
+	{
+		this->rateScheduleInternal(ref, slot, funcId, QThread::currentThread(), currCallbackData.rateDeadlineMs);
+		return;
+	}
+	currCallbackData.rateScheduled = false;
+	if (!currCallbackData.ratePending)
+	{
+		return;
+	}
+	auto funcPending  = currCallbackData.ratePending;
+	auto currCallback = currCallbackData.callback;
+	auto connection   = currCallbackData.connection;
+	auto priority     = currCallbackData.ratePriority;
+	currCallbackData.ratePending = nullptr;
+	currCallbackData.rateLastMs  = nowMs;
+	// call without lock, already in the thread of the subscription
+	locker.unlock();
+	// no triggering thread to call it in, direct calls are made as soon as the interval ends
+	if (connection == Qt::DirectConnection)
+	{
+		funcPending(currCallback);
+		return;
+	}
+	// queue in the lane of the priority, like the calls of the triggers that were not dropped
+	auto p_currObject = QDynamicEventsDataBase::getObjectForThread(QThread::currentThread());
+	p_currObject->post([ref, funcPending, currCallback]() mutable {
+		funcPending(currCallback);
+		// unused, but we need it to keep at least one reference until all callbacks are executed
+		Q_UNUSED(ref)
+	}, priority);
+}
+
+template<class ...Types>
+void QDynamicEventsData<Types...>::retainedFunctionTemplate(std::function<void(Types(&...args))> callback, Types(&...args))
+{
+	callback(args...);
+}
+
+template<class ...Types>
+int QDynamicEventsData<Types...>::acquireSlot(qlonglong &funcId, std::function<void(Types(&...args))> &callback, std::function<bool(Types(&...args))> &filter, Qt::ConnectionType &connection, Qt::EventPriority &priority)
+{
+	// [NOTE] No lock in internal methods
+	int slot;
+	if (m_freeSlots.isEmpty())
+	{
+		slot = m_slots.count();
+		m_slots.append(CallbackData());
+	}
+	else
+	{
+		slot = m_freeSlots.takeLast();
+	}
+	auto &slotData = m_slots[slot];
+	slotData.callback   = callback  ;
+	slotData.filter     = filter    ;
+	slotData.connection = connection;
+	slotData.priority   = priority  ;
+	slotData.rate           = QDynamicEventsRate();
+	slotData.rateLastMs     = -1;
+	slotData.rateDeadlineMs = -1;
+	slotData.rateCount      = 0;
+	slotData.rateScheduled  = false;
+	slotData.ratePending    = nullptr;
+	slotData.ratePriority   = priority;
+	slotData.funcId     = funcId    ;
+	slotData.refCount   = 0;
+	return slot;
+}
+
+template<class ...Types>
+bool QDynamicEventsData<Types...>::isSlotValid(const int &slot, const qlonglong &funcId)
+{
+	// [NOTE] No lock in internal methods
+	return slot >= 0 && slot < m_slots.count() && m_slots.at(slot).funcId == funcId;
+}
+
+template<class ...Types>
+void QDynamicEventsData<Types...>::releaseSlotRef(const int &slot, const qlonglong &funcId)
+{
+	// [NOTE] No lock in internal methods
+	if (!this->isSlotValid(slot, funcId))
+	{
+		// entry was stale, it is now gone
+		m_staleCount = qMax(0, m_staleCount - 1);
+		return;
+	}
+	if (--m_slots[slot].refCount <= 0)
+	{
+		this->freeSlot(slot);
+	}
+}
+
+template<class ...Types>
+void QDynamicEventsData<Types...>::freeSlot(const int &slot)
+{
+	// [NOTE] No lock in internal methods
+	auto &slotData = m_slots[slot];
+	slotData.callback = nullptr;
+	slotData.filter   = nullptr;
+	slotData.ratePending = nullptr;
+	slotData.funcId   = -1;
+	slotData.refCount = 0;
+	m_freeSlots.append(slot);
+}
+
+template<class ...Types>
+void QDynamicEventsData<Types...>::purgeStaleInternal()
+{
+	// [NOTE] No lock in internal methods
+	for (auto itName = m_callbacksMap.begin(); itName != m_callbacksMap.end(); ++itName)
+	{
+		for (auto itThread = itName.value().begin(); itThread != itName.value().end(); ++itThread)
+		{
+			auto &mapOnlyCallbacks = itThread.value();
+			for (auto it = mapOnlyCallbacks.begin(); it != mapOnlyCallbacks.end();)
+			{
+				if (this->isSlotValid(it.value(), it.key()))
+				{
+					++it;
+					continue;
+				}
+				it = mapOnlyCallbacks.erase(it);
+			}
+		}
+	}
+	for (auto itName = m_callbacksMapOnce.begin(); itName != m_callbacksMapOnce.end(); ++itName)
+	{
+		for (auto itThread = itName.value().begin(); itThread != itName.value().end(); ++itThread)
+		{
+			auto &mapOnlyCallbacksOnce = itThread.value();
+			for (auto it = mapOnlyCallbacksOnce.begin(); it != mapOnlyCallbacksOnce.end();)
+			{
+				if (this->isSlotValid(it.value(), it.key()))
+				{
+					++it;
+					continue;
+				}
+				it = mapOnlyCallbacksOnce.erase(it);
+			}
+		}
+	}
+	m_staleCount = 0;
+	// drop patterns nobody is subscribed to anymore
+	auto listPatterns = m_topicTrie.patterns();
+	for (int i = 0; i < listPatterns.count(); i++)
+	{
+		if (!hasCallbacksInternal(listPatterns[i]))
+		{
+			m_topicTrie.removePattern(listPatterns[i]);
+		}
+	}
+}
+
+template<class ...Types>
+bool QDynamicEventsData<Types...>::hasCallbacksInternal(const QString &strEventName)
+{
+	// [NOTE] No lock in internal methods
+	for (auto mapOnlyCallbacks : m_callbacksMap.value(strEventName))
+	{
+		if (!mapOnlyCallbacks.isEmpty())
+		{
+			return true;
+		}
+	}
+	for (auto mapOnlyCallbacksOnce : m_callbacksMapOnce.value(strEventName))
+	{
+		if (!mapOnlyCallbacksOnce.isEmpty())
+		{
+			return true;
+		}
+	}
+	return false;
 }
 
 template<class ...Types>
@@ -220,116 +864,197 @@ void QDynamicEventsData<Types...>::createProxyObj(QString &strEventName)
 	// create obj for thread if not existing, else return existing
 	QDynamicEventsProxyObject * p_obj = QDynamicEventsDataBase::getObjectForThread(p_currThd);
 	// split by spaces
-	QStringList listEventNames = strEventName.split(QRegExp("\\s+"), QString::SkipEmptyParts);
+	QStringList listEventNames = QDynamicEventsDataBase::splitEventNames(strEventName);
 	// for each event name
 	for (int i = 0; i < listEventNames.count(); i++)
 	{
 		QString strCurrEvtName = listEventNames[i];
 		// wait until object destroyed to remove callbacks struct
 		// NOTE : need to disconnect these connections to avoid memory leaks due to lambda memory allocations
-		m_connectionList.append(QObject::connect(p_obj, &QObject::destroyed, [this, strCurrEvtName, p_currThd]() {
+		m_connectionList.append(QObject::connect(p_obj, &QObject::destroyed, [this, strCurrEvtName, p_currThd]() mutable {
+			QMutexLocker locker(&this->m_mutex);
 			// delete callbacks when thread gets deleted
-			this->m_callbacksMap[strCurrEvtName].remove(p_currThd);
-			this->m_callbacksMapOnce[strCurrEvtName].remove(p_currThd);
+			this->offInternal(strCurrEvtName, p_currThd);
 		}));
 	}
 }
 
 template<class ...Types>
-QDynamicEventsHandle QDynamicEventsData<Types...>::on(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/)
+QDynamicEventsHandle QDynamicEventsData<Types...>::on(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/, Qt::EventPriority priority/* = Qt::NormalEventPriority*/, QDynamicEventsRate rate/* = QDynamicEventsRate()*/)
 {
 	// split by spaces
-	QStringList listEventNames = strEventName.split(QRegExp("\\s+"), QString::SkipEmptyParts);
+	QStringList listEventNames = QDynamicEventsDataBase::splitEventNames(strEventName);
 	// create proxy object if necessary
 	this->createProxyObj(strEventName);
 	// get callback uuid
-	qlonglong funcId = QDynamicEventsDataBase::s_funcId++;
+	qlonglong funcId = QDynamicEventsDataBase::s_funcId.fetchAndAddRelaxed(1);
 	// lock after
 	QMutexLocker locker(&m_mutex);
+	// store callback data once, shared by all event names
+	int slot = this->acquireSlot(funcId, callback, filter, connection, priority);
+	m_slots[slot].rate = rate;
 	// for each event name
 	for (int i = 0; i < listEventNames.count(); i++)
 	{
-		onInternal(listEventNames[i], funcId, callback, filter, connection);
+		onInternal(listEventNames[i], funcId, slot);
+	}
+	// late subscriber gets the current value of retained events
+	if (!m_retainedMap.isEmpty())
+	{
+		this->deliverRetainedInternal(listEventNames, slot, false);
 	}
 	// return hash
-	return QDynamicEventsHandle(strEventName, QThread::currentThread(), funcId);
+	return QDynamicEventsHandle(strEventName, QThread::currentThread(), funcId, slot);
 }
 
 template<class ...Types>
-void QDynamicEventsData<Types...>::onInternal(QString &strEventName, qlonglong &funcId, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/)
+void QDynamicEventsData<Types...>::onInternal(QString &strEventName, qlonglong &funcId, int &slot)
 {
 	// [NOTE] No lock in internal methods
-	m_callbacksMap[strEventName][QThread::currentThread()][funcId].callback   = callback  ;
-	m_callbacksMap[strEventName][QThread::currentThread()][funcId].filter     = filter    ;
-	m_callbacksMap[strEventName][QThread::currentThread()][funcId].connection = connection;
+	auto &mapOnlyCallbacks = m_callbacksMap[strEventName][QThread::currentThread()];
+	// same event name might be repeated in the list
+	if (mapOnlyCallbacks.contains(funcId))
+	{
+		return;
+	}
+	mapOnlyCallbacks[funcId] = slot;
+	m_slots[slot].refCount++;
+	// wildcard subscriptions are also added to the topic trie
+	if (QDynamicEventsTopicTrie::isPattern(strEventName))
+	{
+		m_topicTrie.addPattern(strEventName);
+	}
 }
 
 template<class ...Types>
-QDynamicEventsHandle QDynamicEventsData<Types...>::once(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/)
+QDynamicEventsHandle QDynamicEventsData<Types...>::once(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/, Qt::EventPriority priority/* = Qt::NormalEventPriority*/)
 {
 	// split by spaces
-	QStringList listEventNames = strEventName.split(QRegExp("\\s+"), QString::SkipEmptyParts);
+	QStringList listEventNames = QDynamicEventsDataBase::splitEventNames(strEventName);
 	// create proxy object if necessary
 	this->createProxyObj(strEventName);
 	// get callback uuid
-	qlonglong funcId = QDynamicEventsDataBase::s_funcId++;
+	qlonglong funcId = QDynamicEventsDataBase::s_funcId.fetchAndAddRelaxed(1);
 	// lock after
 	QMutexLocker locker(&m_mutex);
+	// store callback data once, shared by all event names
+	int slot = this->acquireSlot(funcId, callback, filter, connection, priority);
+	// no need to subscribe if a retained value is already there
+	if (!m_retainedMap.isEmpty() && this->deliverRetainedInternal(listEventNames, slot, true))
+	{
+		// NOTE : slot might have been released already by a direct callback calling off(handle)
+		if (this->isSlotValid(slot, funcId))
+		{
+			this->freeSlot(slot);
+		}
+		return QDynamicEventsHandle(strEventName, QThread::currentThread(), funcId, slot);
+	}
 	// for each event name
 	for (int i = 0; i < listEventNames.count(); i++)
 	{
-		onceInternal(listEventNames[i], funcId, callback, filter, connection);
+		onceInternal(listEventNames[i], funcId, slot);
 	}
 	// return hash
-	return QDynamicEventsHandle(strEventName, QThread::currentThread(), funcId);
+	return QDynamicEventsHandle(strEventName, QThread::currentThread(), funcId, slot);
 }
 
 template<class ...Types>
-void QDynamicEventsData<Types...>::onceInternal(QString &strEventName, qlonglong &funcId, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/)
+void QDynamicEventsData<Types...>::onceInternal(QString &strEventName, qlonglong &funcId, int &slot)
 {
 	// [NOTE] No lock in internal methods
-	m_callbacksMapOnce[strEventName][QThread::currentThread()][funcId].callback   = callback  ;
-	m_callbacksMapOnce[strEventName][QThread::currentThread()][funcId].filter     = filter    ;
-	m_callbacksMapOnce[strEventName][QThread::currentThread()][funcId].connection = connection;
+	auto &mapOnlyCallbacksOnce = m_callbacksMapOnce[strEventName][QThread::currentThread()];
+	// same event name might be repeated in the list
+	if (mapOnlyCallbacksOnce.contains(funcId))
+	{
+		return;
+	}
+	mapOnlyCallbacksOnce[funcId] = slot;
+	m_slots[slot].refCount++;
+	// wildcard subscriptions are also added to the topic trie
+	if (QDynamicEventsTopicTrie::isPattern(strEventName))
+	{
+		m_topicTrie.addPattern(strEventName);
+	}
 }
 
 template<class ...Types>
 void QDynamicEventsData<Types...>::trigger(QDynamicEvents<Types...> ref, QString strEventName, Types(&...args))
+{
+	this->trigger(ref, Qt::NormalEventPriority, strEventName, args...);
+}
+
+template<class ...Types>
+void QDynamicEventsData<Types...>::trigger(QDynamicEvents<Types...> ref, const Qt::EventPriority &priority, QString strEventName, Types(&...args))
 {
 	QMutexLocker locker(&m_mutex);	
 	// split by spaces
-	QStringList listEventNames = strEventName.split(QRegExp("\\s+"), QString::SkipEmptyParts);
+	QStringList listEventNames = QDynamicEventsDataBase::splitEventNames(strEventName);
 	// for each event name
 	for (int i = 0; i < listEventNames.count(); i++)
 	{
-		triggerInternal(ref, listEventNames[i], args...);
+		// store args of retained events before calling, so callbacks subscribing from a callback get them
+		if (m_retainedMap.contains(listEventNames[i]))
+		{
+			m_retainedMap[listEventNames[i]] = QSharedPointer<const BoundArgsFunction>(new BoundArgsFunction(std::bind(&QDynamicEventsData<Types...>::retainedFunctionTemplate, std::placeholders::_1, args...)));
+		}
+		triggerInternal(ref, priority, listEventNames[i], args...);
+		// also trigger callbacks subscribed with a matching wildcard pattern
+		if (m_topicTrie.isEmpty())
+		{
+			continue;
+		}
+		auto listPatterns = m_topicTrie.match(listEventNames[i]);
+		for (int j = 0; j < listPatterns.count(); j++)
+		{
+			// already triggered above if the event name is literally the pattern
+			if (listPatterns[j] == listEventNames[i])
+			{
+				continue;
+			}
+			triggerInternal(ref, priority, listPatterns[j], args...);
+		}
 	}
 }
 
 template<class ...Types>
-void QDynamicEventsData<Types...>::triggerInternal(QDynamicEvents<Types...> ref, QString &strEventName, Types(&...args))
+void QDynamicEventsData<Types...>::triggerInternal(QDynamicEvents<Types...> ref, const Qt::EventPriority &priority, QString &strEventName, Types(&...args))
 {
 	// [NOTE] No lock in internal methods
 
 	// on method callbacks *********************************************************
 	// for each thread where there are callbacks to be called
-	auto listThreads = m_callbacksMap[strEventName].keys();
+	// NOTE : use value() to avoid adding entries for event names nobody subscribed to
+	auto listThreads = m_callbacksMap.value(strEventName).keys();
 	for (int i = 0; i < listThreads.count(); i++)
 	{
-		auto p_currThread      = listThreads.at(i);
-		auto p_currObject      = QDynamicEventsDataBase::getObjectForThread(p_currThread);
-		auto &mapOnlyCallbacks = this->m_callbacksMap[strEventName][p_currThread];
+		auto p_currThread     = listThreads.at(i);
+		auto p_currObject     = QDynamicEventsDataBase::getObjectForThread(p_currThread);
+		// NOTE : iterate a (cheap, implicitly shared) copy since direct callbacks can subscribe or unsubscribe
+		auto mapOnlyCallbacks = this->m_callbacksMap[strEventName][p_currThread];
 		// loop all callbacks for current thread
-		auto listHandles = mapOnlyCallbacks.keys();
-		for (int j = 0; j < listHandles.count(); j++)
+		for (auto it = mapOnlyCallbacks.constBegin(); it != mapOnlyCallbacks.constEnd(); ++it)
 		{
-			auto currHandle        = listHandles.at(j);
-			auto &currCallbackData = mapOnlyCallbacks[currHandle];
+			auto currHandle = it.key();
+			auto currSlot   = it.value();
+			// purge entries left behind by off(handle)
+			if (!this->isSlotValid(currSlot, currHandle))
+			{
+				this->m_callbacksMap[strEventName][p_currThread].remove(currHandle);
+				m_staleCount = qMax(0, m_staleCount - 1);
+				continue;
+			}
+			// NOTE : copy callback data, a direct callback might call off(handle) or off() and release the slot
+			auto currCallbackData = m_slots.at(currSlot);
 			// skip filtered
 			if (currCallbackData.filter && !currCallbackData.filter(args...))
 			{
 				continue;
 			}
+			// skip rate limited, before anything gets queued
+			if (currCallbackData.rate.mode != QDynamicEventsRate::None && !this->rateAllowInternal(ref, priority, currSlot, currHandle, p_currThread, args...))
+			{
+				continue;
+			}
 			// invoke according to connection type
 			if (currCallbackData.connection == Qt::DirectConnection || (currCallbackData.connection == Qt::AutoConnection && p_currThread == QThread::currentThread()))
 			{
@@ -339,17 +1064,14 @@ void QDynamicEventsData<Types...>::triggerInternal(QDynamicEvents<Types...> ref,
 			else if (currCallbackData.connection == Qt::QueuedConnection || (currCallbackData.connection == Qt::AutoConnection && p_currThread != QThread::currentThread()))
 			{
 				// get copy of callback to be executed in thread
-				auto &currCallback = currCallbackData.callback;
-				// create object in heap and assign function (event loop takes ownership and deletes it later)
-				QDynamicEventsProxyEvent * p_Evt = new QDynamicEventsProxyEvent;
+				auto currCallback = currCallbackData.callback;
 				// NOTE need to pass currCallback as copy because if an off() gets execd before event loop resumes, callbacks will not be called
-				p_Evt->m_eventFunc = [ref, currCallback, args...]() mutable {
+				// queue function in the mailbox of the object with correct thread affinity (event loop wakes up once per batch)
+				p_currObject->post([ref, currCallback, args...]() mutable {
 					currCallback(args...);
 					// unused, but we need it to keep at least one reference until all callbacks are executed
 					Q_UNUSED(ref)
-				};
-				// post event for object with correct thread affinity
-				QCoreApplication::postEvent(p_currObject, p_Evt);
+				}, qMax(priority, currCallbackData.priority));
 			}
 			else
 			{
@@ -360,21 +1082,29 @@ void QDynamicEventsData<Types...>::triggerInternal(QDynamicEvents<Types...> ref,
 
 	// once method callbacks *********************************************************
 	// for each thread where there are callbacks to be called
-	auto listThreadsOnce = m_callbacksMapOnce[strEventName].keys();
+	auto listThreadsOnce = m_callbacksMapOnce.value(strEventName).keys();
 	for (int i = 0; i < listThreadsOnce.count(); i++)
 	{
 		auto p_currThread         = listThreadsOnce.at(i);
 		auto p_currObject         = QDynamicEventsDataBase::getObjectForThread(p_currThread);
 		auto mapOnlyCallbacksOnce = this->m_callbacksMapOnce[strEventName].take(p_currThread);
 		// filter callbacks
-		auto listHandles = mapOnlyCallbacksOnce.keys();
-		for (int j = 0; j < listHandles.count(); j++)
+		for (auto it = mapOnlyCallbacksOnce.constBegin(); it != mapOnlyCallbacksOnce.constEnd(); ++it)
 		{
-			auto currHandle            = listHandles.at(j);
-			auto &currCallbackDataOnce = mapOnlyCallbacksOnce[currHandle];
+			auto currHandle = it.key();
+			auto currSlot   = it.value();
+			// entries left behind by off(handle) are just dropped
+			if (!this->isSlotValid(currSlot, currHandle))
+			{
+				m_staleCount = qMax(0, m_staleCount - 1);
+				continue;
+			}
+			// NOTE : copy callback data, a direct callback might call off(handle) or off() and release the slot
+			auto currCallbackDataOnce = m_slots.at(currSlot);
 			// skip filtered
 			if (currCallbackDataOnce.filter && !currCallbackDataOnce.filter(args...))
 			{
+				this->releaseSlotRef(currSlot, currHandle);
 				continue;
 			}
 			// invoke according to connection type
@@ -386,22 +1116,25 @@ void QDynamicEventsData<Types...>::triggerInternal(QDynamicEvents<Types...> ref,
 			else if (currCallbackDataOnce.connection == Qt::QueuedConnection || (currCallbackDataOnce.connection == Qt::AutoConnection && p_currThread != QThread::currentThread()))
 			{
 				// get copy of callback to be executed in thread
-				auto &currCallbackOnce = currCallbackDataOnce.callback;
-				// create object in heap and assign function (event loop takes ownership and deletes it later)
-				QDynamicEventsProxyEvent * p_Evt = new QDynamicEventsProxyEvent;
+				auto currCallbackOnce = currCallbackDataOnce.callback;
 				// NOTE below the difference is the 'take' method which ensures callbacks are only execd once
-				p_Evt->m_eventFunc = [ref, currCallbackOnce, args...]() mutable {
+				// queue function in the mailbox of the object with correct thread affinity (event loop wakes up once per batch)
+				p_currObject->post([ref, currCallbackOnce, args...]() mutable {
 					currCallbackOnce(args...);
 					// unused, but we need it to keep at least one reference until all callbacks are executed
 					Q_UNUSED(ref)
-				};
-				// post event for object with correct thread affinity
-				QCoreApplication::postEvent(p_currObject, p_Evt);
+				}, qMax(priority, currCallbackDataOnce.priority));
 			}
 			else
 			{
 				Q_ASSERT_X(false, "QDynamicEventsData<Types...>::triggerInternal", "Unsupported connection type.");
 			}
+			// entry was taken from the map, slot is freed once no other event name refers to it
+			// NOTE : a direct callback might have already removed itself with off(handle)
+			if (this->isSlotValid(currSlot, currHandle))
+			{
+				this->releaseSlotRef(currSlot, currHandle);
+			}
 		} // for j
 	} // for i
 }
@@ -5,41 +5,168 @@ QEventer::QEventer()
 	// nothing to do here
 }
 
-QEventer::QEventer(const QEventer &other) :
-	m_mapEventers(other.m_mapEventers)
+QEventer::QEventer(const QEventer &other)
 {
-	// nothing to do here
+	// NOTE : copies share subscriptions (like QDynamicEvents copies do), but each one owns its table entries
+	for (int i = 0; i < QEventer::typeCount(); i++)
+	{
+		auto p_eventer = other.eventerAt(i);
+		if (p_eventer)
+		{
+			this->publishEventer(i, p_eventer->clone());
+		}
+	}
+	QMutexLocker locker(&other.m_nameMutex);
+	m_nameIndex = other.m_nameIndex;
 }
 
 QEventer::~QEventer()
 {
-	qDeleteAll(m_mapEventers);
-	m_mapEventers.clear();
+	for (int i = 0; i < QEVENTER_CHUNK_COUNT; i++)
+	{
+		auto p_chunk = m_chunks[i].loadAcquire();
+		if (!p_chunk)
+		{
+			continue;
+		}
+		for (int j = 0; j < QEVENTER_CHUNK_SIZE; j++)
+		{
+			delete p_chunk->eventers[j].loadAcquire();
+		}
+		delete p_chunk;
+	}
 }
 
 void QEventer::off(const QString &strEventName)
 {
-	QMapIterator<std::type_index, QAbstractDynamicEvents*> i(m_mapEventers);
-	while (i.hasNext()) {
-		i.next();
-		i.value()->off(strEventName);
+	QStringList listEventNames = QDynamicEventsDataBase::splitEventNames(strEventName);
+	for (int i = 0; i < listEventNames.count(); i++)
+	{
+		// only eventers which had subscriptions to the event name
+		QSet<int> setIndexes;
+		{
+			QMutexLocker locker(&m_nameMutex);
+			setIndexes = m_nameIndex.take(listEventNames[i]);
+		}
+		for (auto it = setIndexes.constBegin(); it != setIndexes.constEnd(); ++it)
+		{
+			auto p_eventer = this->eventerAt(*it);
+			if (p_eventer)
+			{
+				p_eventer->off(listEventNames[i]);
+			}
+		}
 	}
 }
 
 void QEventer::off(const QDynamicEventsHandle &evtHandle)
 {
-	QMapIterator<std::type_index, QAbstractDynamicEvents*> i(m_mapEventers);
-	while (i.hasNext()) {
-		i.next();
-		i.value()->off(evtHandle);
+	// handle knows its eventer
+	if (evtHandle.m_eventerIndex >= 0)
+	{
+		auto p_eventer = this->eventerAt(evtHandle.m_eventerIndex);
+		if (p_eventer)
+		{
+			p_eventer->off(evtHandle);
+		}
+		return;
+	}
+	// handle not created by a QEventer, let each eventer check it
+	for (int i = 0; i < QEventer::typeCount(); i++)
+	{
+		auto p_eventer = this->eventerAt(i);
+		if (p_eventer)
+		{
+			p_eventer->off(evtHandle);
+		}
 	}
 }
 
 void QEventer::off()
 {
-	QMapIterator<std::type_index, QAbstractDynamicEvents*> i(m_mapEventers);
-	while (i.hasNext()) {
-		i.next();
-		i.value()->off();
+	{
+		QMutexLocker locker(&m_nameMutex);
+		m_nameIndex.clear();
+	}
+	for (int i = 0; i < QEventer::typeCount(); i++)
+	{
+		auto p_eventer = this->eventerAt(i);
+		if (p_eventer)
+		{
+			p_eventer->off();
+		}
+	}
+}
+
+void QEventer::indexHandle(QDynamicEventsHandle &evtHandle, const int &index)
+{
+	evtHandle.m_eventerIndex = index;
+	QStringList listEventNames = QDynamicEventsDataBase::splitEventNames(evtHandle.m_strEventName);
+	QMutexLocker locker(&m_nameMutex);
+	for (int i = 0; i < listEventNames.count(); i++)
+	{
+		// NOTE : entries are not removed by off(handle), a stale entry only costs a useless off(name) call
+		m_nameIndex[listEventNames[i]].insert(index);
+	}
+}
+
+QAbstractDynamicEvents * QEventer::eventerAt(const int &index) const
+{
+	// NOTE : checked in release builds too, a larger index would read out of bounds
+	if (index < 0 || index >= QEVENTER_CHUNK_COUNT * QEVENTER_CHUNK_SIZE)
+	{
+		qFatal("QEventer::eventerAt : Too many type combinations, increase QEVENTER_CHUNK_COUNT.");
+	}
+	auto p_chunk = m_chunks[index / QEVENTER_CHUNK_SIZE].loadAcquire();
+	if (!p_chunk)
+	{
+		return nullptr;
 	}
+	return p_chunk->eventers[index % QEVENTER_CHUNK_SIZE].loadAcquire();
+}
+
+QAbstractDynamicEvents * QEventer::publishEventer(const int &index, QAbstractDynamicEvents * p_eventer)
+{
+	// NOTE : checked in release builds too, a larger index would write out of bounds
+	if (index < 0 || index >= QEVENTER_CHUNK_COUNT * QEVENTER_CHUNK_SIZE)
+	{
+		qFatal("QEventer::publishEventer : Too many type combinations, increase QEVENTER_CHUNK_COUNT.");
+	}
+	auto &chunkPtr = m_chunks[index / QEVENTER_CHUNK_SIZE];
+	auto p_chunk   = chunkPtr.loadAcquire();
+	// create chunk if needed, another thread might be doing the same
+	if (!p_chunk)
+	{
+		auto p_newChunk = new EventerChunk;
+		if (chunkPtr.testAndSetOrdered(nullptr, p_newChunk))
+		{
+			p_chunk = p_newChunk;
+		}
+		else
+		{
+			delete p_newChunk;
+			p_chunk = chunkPtr.loadAcquire();
+		}
+	}
+	// publish eventer, if another thread won the race use its eventer instead
+	auto &eventerPtr = p_chunk->eventers[index % QEVENTER_CHUNK_SIZE];
+	if (eventerPtr.testAndSetOrdered(nullptr, p_eventer))
+	{
+		return p_eventer;
+	}
+	delete p_eventer;
+	return eventerPtr.loadAcquire();
+}
+
+int QEventer::typeCount()
+{
+	// only indexes given so far can have an eventer
+	return qMin(s_typeCount.loadAcquire(), QEVENTER_CHUNK_COUNT * QEVENTER_CHUNK_SIZE);
+}
+
+QAtomicInt QEventer::s_typeCount(0);
+
+int QEventer::nextTypeIndex()
+{
+	return s_typeCount.fetchAndAddOrdered(1);
 }
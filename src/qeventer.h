@@ -1,10 +1,11 @@
 #ifndef QEVENTER_H
 #define QEVENTER_H
 
-#include <typeinfo>
-#include <typeindex>
-
-#include <QMap>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QMutex>
+#include <QHash>
+#include <QSet>
 #include <QScopedPointer>
 #include <QVariant>
 
@@ -12,6 +13,11 @@
 
 // TODO : pass on the const & idiom deeper into implementation
 
+// eventers table is split in chunks which are allocated on demand, so it never needs to be reallocated
+// NOTE : holds up to QEVENTER_CHUNK_COUNT * QEVENTER_CHUNK_SIZE type combinations, more is a fatal error (qFatal)
+#define QEVENTER_CHUNK_SIZE  64
+#define QEVENTER_CHUNK_COUNT 64
+
 // base class to inherit from to add all eventer's functionality
 class QEventer
 {
@@ -28,16 +34,19 @@ public:
 	QDynamicEventsHandle on(const QString &strEventName, 
 		                    const T1      &callback, 
 		                    const T2      &filter = nullptr, 
-		                    const Qt::ConnectionType &connection = Qt::AutoConnection) {
-		return onAlias<Types...>(strEventName, callback, filter, connection);
+		                    const Qt::ConnectionType &connection = Qt::AutoConnection,
+		                    const Qt::EventPriority  &priority   = Qt::NormalEventPriority,
+		                    const QDynamicEventsRate &rate       = QDynamicEventsRate()) {
+		return onAlias<Types...>(strEventName, callback, filter, connection, priority, rate);
 	};
 	// once method	
 	template<typename ...Types, typename T1, typename T2>
 	QDynamicEventsHandle once(const QString &strEventName, 
 		                      const T1      &callback, 
 		                      const T2      &filter = nullptr, 
-		                      const Qt::ConnectionType &connection = Qt::AutoConnection) {
-		return onceAlias<Types...>(strEventName, callback, filter, connection);
+		                      const Qt::ConnectionType &connection = Qt::AutoConnection,
+		                      const Qt::EventPriority  &priority   = Qt::NormalEventPriority) {
+		return onceAlias<Types...>(strEventName, callback, filter, connection, priority);
 	};
 	// off method (all callbacks registered to an specific event name)
 	void off(const QString &strEventName);
@@ -46,55 +55,125 @@ public:
 	// off method (all callbacks)
 	void off();
 
+	// retained API
+
+	// enable or disable retained mode, last triggered args are delivered to callbacks subscribed later
+	template<typename ...Types>
+	void setRetained(const QString &strEventName, const bool &retained = true);
+	// check if retained mode is enabled
+	template<typename ...Types>
+	bool isRetained(const QString &strEventName);
+	// forget last triggered args, retained mode stays enabled
+	template<typename ...Types>
+	void clearRetained(const QString &strEventName);
+
 	// provider API
 
 	// trigger event method
 	template<typename ...Types>
 	void trigger(QString strEventName, Types(...args));
+	// trigger event method, queued callbacks are delivered in the lane of the given priority
+	template<typename ...Types>
+	void trigger(const Qt::EventPriority &priority, QString strEventName, Types(...args));
 
 protected:
 	// without alias would work, but annoying intellisense appears 
 	template<typename ...Types>
-	QDynamicEventsHandle onAlias(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection);
+	QDynamicEventsHandle onAlias(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection, Qt::EventPriority priority = Qt::NormalEventPriority, QDynamicEventsRate rate = QDynamicEventsRate());
 	template<typename ...Types>
-	QDynamicEventsHandle onceAlias(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection);
+	QDynamicEventsHandle onceAlias(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter = nullptr, Qt::ConnectionType connection = Qt::AutoConnection, Qt::EventPriority priority = Qt::NormalEventPriority);
 
 	/*
-	use combination of QMap and template function to emulate variable templates
+	use a function local static per Types... to emulate variable templates, each combination of types
+	gets a unique index the first time it is used, which is then used to index a table of eventers
 	http://en.cppreference.com/w/cpp/language/variable_template
 	https://stackoverflow.com/questions/37912378/variable-templates-only-available-with-c14
-	http://en.cppreference.com/w/cpp/types/type_index
+	NOTE : * the table can be used from multiple threads without an external mutex, chunks and eventers
+	         are created lazily and published with a CAS (the loser deletes its own copy), once published
+	         they never move nor get deleted until the QEventer is destroyed, so reading is lock-free
 	*/
-	QMap<std::type_index, QAbstractDynamicEvents*> m_mapEventers;
+	struct EventerChunk
+	{
+		QAtomicPointer<QAbstractDynamicEvents> eventers[QEVENTER_CHUNK_SIZE];
+	};
+	QAtomicPointer<EventerChunk> m_chunks[QEVENTER_CHUNK_COUNT];
 	template<typename ...Types>
-	QDynamicEvents<Types...> getEventer();
+	QDynamicEvents<Types...> &getEventer();
+	// get eventer at index, nullptr if not created yet
+	QAbstractDynamicEvents * eventerAt(const int &index) const;
+	// publish eventer at index if none is there yet, returns the one that got published
+	QAbstractDynamicEvents * publishEventer(const int &index, QAbstractDynamicEvents * p_eventer);
+	// event names to indexes of the eventers with subscriptions to them, so off(name) only visits those
+	// NOTE : only touched when subscribing and unsubscribing, never when triggering
+	QHash<QString, QSet<int>> m_nameIndex;
+	mutable QMutex            m_nameMutex;
+	// record eventer index in handle and index its event names
+	void indexHandle(QDynamicEventsHandle &evtHandle, const int &index);
+	// unique index of a Types... combination
+	// NOTE : one static per binary, a Types... used from different shared libraries might get different indexes
+	template<typename ...Types>
+	static int typeIndex();
+	static int nextTypeIndex();
+	// number of indexes given so far
+	static int typeCount();
+	static QAtomicInt s_typeCount;
 };
 
 template<typename ...Types>
-QDynamicEvents<Types...> QEventer::getEventer()
+int QEventer::typeIndex()
+{
+	// NOTE : thread safe initialization since c++11
+	static const int index = QEventer::nextTypeIndex();
+	return index;
+}
+
+template<typename ...Types>
+QDynamicEvents<Types...> &QEventer::getEventer()
 {
+	const int index = QEventer::typeIndex<Types...>();
+	auto p_eventer  = this->eventerAt(index);
 	// create once eventer for each Types... (combination of types) used in code
-	if (!m_mapEventers.contains(std::type_index(typeid(QDynamicEvents<Types...>))))
+	if (!p_eventer)
 	{
-		m_mapEventers[std::type_index(typeid(QDynamicEvents<Types...>))] = new QDynamicEvents<Types...>;
-		//qDebug() << "[INFO] Created eventer for type " << typeid(QDynamicEvents<Types...>).name();
+		p_eventer = this->publishEventer(index, new QDynamicEvents<Types...>);
 	}
-	// dereference and return
-	return *(static_cast<QDynamicEvents<Types...> *>(m_mapEventers[std::type_index(typeid(QDynamicEvents<Types...>))]));
+	// dereference and return, no copy
+	return *(static_cast<QDynamicEvents<Types...> *>(p_eventer));
 }
 
 template<typename ...Types>
-QDynamicEventsHandle QEventer::onAlias(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/)
+QDynamicEventsHandle QEventer::onAlias(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/, Qt::EventPriority priority/* = Qt::NormalEventPriority*/, QDynamicEventsRate rate/* = QDynamicEventsRate()*/)
 {
-	return getEventer<Types...>().on(strEventName, callback, filter, connection);
+	auto evtHandle = getEventer<Types...>().on(strEventName, callback, filter, connection, priority, rate);
+	this->indexHandle(evtHandle, QEventer::typeIndex<Types...>());
+	return evtHandle;
 }
 
 template<typename ...Types>
-QDynamicEventsHandle QEventer::onceAlias(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/)
+QDynamicEventsHandle QEventer::onceAlias(QString strEventName, std::function<void(Types(&...args))> callback, std::function<bool(Types(&...args))> filter/* = nullptr*/, Qt::ConnectionType connection/* = Qt::AutoConnection*/, Qt::EventPriority priority/* = Qt::NormalEventPriority*/)
 {
-	return getEventer<Types...>().once(strEventName, callback, filter, connection);
+	auto evtHandle = getEventer<Types...>().once(strEventName, callback, filter, connection, priority);
+	this->indexHandle(evtHandle, QEventer::typeIndex<Types...>());
+	return evtHandle;
 }
 
+template<typename ...Types>
+void QEventer::setRetained(const QString &strEventName, const bool &retained/* = true*/)
+{
+	getEventer<Types...>().setRetained(strEventName, retained);
+}
+
+template<typename ...Types>
+bool QEventer::isRetained(const QString &strEventName)
+{
+	return getEventer<Types...>().isRetained(strEventName);
+}
+
+template<typename ...Types>
+void QEventer::clearRetained(const QString &strEventName)
+{
+	getEventer<Types...>().clearRetained(strEventName);
+}
 
 template<typename ...Types>
 void QEventer::trigger(QString strEventName, Types(...args))
@@ -102,4 +181,10 @@ void QEventer::trigger(QString strEventName, Types(...args))
 	return getEventer<Types...>().trigger(strEventName, args...);
 }
 
+template<typename ...Types>
+void QEventer::trigger(const Qt::EventPriority &priority, QString strEventName, Types(...args))
+{
+	return getEventer<Types...>().trigger(priority, strEventName, args...);
+}
+
 #endif
\ No newline at end of file
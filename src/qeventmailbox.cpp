@@ -0,0 +1,265 @@
+#include "qeventmailbox.hpp"
+
+QEventMailboxNode::QEventMailboxNode() : m_next(nullptr)
+{
+	// nothing to do here
+}
+
+QEventMailboxNode::~QEventMailboxNode()
+{
+	// nothing to do here
+}
+
+QEventMailbox::Lane::Lane() :
+	m_head(&m_stub),
+	mp_tail(&m_stub),
+	m_scheduled(0),
+	m_priority(Qt::NormalEventPriority),
+	m_depth(0),
+	m_maxDepth(0),
+	m_streak(0)
+{
+	// nothing to do here
+}
+
+QEventMailbox::QEventMailbox(QObject * p_receiver, QEvent::Type wakeupType, int priority/* = Qt::NormalEventPriority*/) :
+	mp_receiver(p_receiver),
+	m_wakeupType(wakeupType),
+	mp_lanes(new Lane[1]),
+	m_laneCount(1),
+	m_maxStreak(0),
+	m_yieldRequested(false)
+{
+	mp_lanes[0].m_priority = priority;
+}
+
+QEventMailbox::QEventMailbox(QObject * p_receiver, QEvent::Type wakeupType, const QList<int> &lanePriorities, int maxStreak/* = 16*/) :
+	mp_receiver(p_receiver),
+	m_wakeupType(wakeupType),
+	mp_lanes(new Lane[qMax(1, lanePriorities.count())]),
+	m_laneCount(qMax(1, lanePriorities.count())),
+	m_maxStreak(maxStreak),
+	m_yieldRequested(false)
+{
+	for (int i = 0; i < lanePriorities.count(); i++)
+	{
+		mp_lanes[i].m_priority = lanePriorities.at(i);
+	}
+}
+
+QEventMailbox::~QEventMailbox()
+{
+	// delete tasks never executed (receiver deleted before processing them)
+	for (int i = 0; i < m_laneCount; i++)
+	{
+		bool isBlocked = false;
+		QEventMailboxNode * p_node = QEventMailbox::pop(mp_lanes[i], isBlocked);
+		while (p_node)
+		{
+			delete p_node;
+			p_node = QEventMailbox::pop(mp_lanes[i], isBlocked);
+		}
+	}
+	delete[] mp_lanes;
+}
+
+void QEventMailbox::postNode(QEventMailboxNode * p_node, int lane/* = 0*/)
+{
+	Q_ASSERT_X(lane >= 0 && lane < m_laneCount, "QEventMailbox::postNode", "Invalid lane.");
+	Lane &currLane = mp_lanes[lane];
+	// update metrics before linking, so depth never goes negative
+	int depth    = currLane.m_depth.fetchAndAddOrdered(1) + 1;
+	int maxDepth = currLane.m_maxDepth.loadAcquire();
+	while (depth > maxDepth && !currLane.m_maxDepth.testAndSetOrdered(maxDepth, depth))
+	{
+		maxDepth = currLane.m_maxDepth.loadAcquire();
+	}
+	QEventMailbox::push(currLane, p_node);
+	this->schedule(currLane);
+}
+
+int QEventMailbox::drain(int maxTasks/* = 1024*/, const QAtomicInt * p_interrupt/* = nullptr*/)
+{
+	// allow producers to post a new wakeup from now on, tasks they queue
+	// while we are draining are executed here anyway (spurious wakeup is harmless)
+	// NOTE : full barrier, the reset must be visible before we start reading the queues
+	for (int i = 0; i < m_laneCount; i++)
+	{
+		mp_lanes[i].m_scheduled.fetchAndStoreOrdered(0);
+	}
+	int  count     = 0;
+	bool isBlocked = false;
+	bool isStopped = false;
+	m_yieldRequested = false;
+	while (count < maxTasks)
+	{
+		if (p_interrupt && p_interrupt->loadAcquire())
+		{
+			isStopped = true;
+			break;
+		}
+		QEventMailboxNode * p_node = this->takeNext(isBlocked);
+		if (!p_node)
+		{
+			break;
+		}
+		p_node->exec();
+		delete p_node;
+		count++;
+		if (m_yieldRequested)
+		{
+			m_yieldRequested = false;
+			isStopped        = true;
+			break;
+		}
+	}
+	// come back later if there is (or might be) something left
+	if (count == maxTasks || isBlocked || isStopped)
+	{
+		for (int i = 0; i < m_laneCount; i++)
+		{
+			if (mp_lanes[i].m_depth.loadAcquire() > 0)
+			{
+				this->schedule(mp_lanes[i]);
+			}
+		}
+	}
+	return count;
+}
+
+void QEventMailbox::yield()
+{
+	m_yieldRequested = true;
+}
+
+int QEventMailbox::discard()
+{
+	int count = 0;
+	for (int i = 0; i < m_laneCount; i++)
+	{
+		bool isBlocked = false;
+		QEventMailboxNode * p_node = QEventMailbox::pop(mp_lanes[i], isBlocked);
+		while (p_node)
+		{
+			mp_lanes[i].m_depth.fetchAndAddOrdered(-1);
+			delete p_node;
+			count++;
+			p_node = QEventMailbox::pop(mp_lanes[i], isBlocked);
+		}
+	}
+	return count;
+}
+
+int QEventMailbox::laneCount() const
+{
+	return m_laneCount;
+}
+
+int QEventMailbox::lanePriority(int lane) const
+{
+	return mp_lanes[lane].m_priority;
+}
+
+int QEventMailbox::depth(int lane) const
+{
+	return mp_lanes[lane].m_depth.loadAcquire();
+}
+
+int QEventMailbox::maxDepth(int lane) const
+{
+	return mp_lanes[lane].m_maxDepth.loadAcquire();
+}
+
+void QEventMailbox::push(Lane &lane, QEventMailboxNode * p_node)
+{
+	p_node->m_next.storeRelease(nullptr);
+	QEventMailboxNode * p_prev = lane.m_head.fetchAndStoreOrdered(p_node);
+	// NOTE : between the two lines the queue is unlinked, consumer sees it as blocked
+	p_prev->m_next.storeRelease(p_node);
+}
+
+QEventMailboxNode * QEventMailbox::pop(Lane &lane, bool &isBlocked)
+{
+	isBlocked = false;
+	QEventMailboxNode * p_tail = lane.mp_tail;
+	QEventMailboxNode * p_next = p_tail->m_next.loadAcquire();
+	// skip stub
+	if (p_tail == &lane.m_stub)
+	{
+		if (!p_next)
+		{
+			// empty
+			return nullptr;
+		}
+		lane.mp_tail = p_next;
+		p_tail       = p_next;
+		p_next       = p_next->m_next.loadAcquire();
+	}
+	if (p_next)
+	{
+		lane.mp_tail = p_next;
+		return p_tail;
+	}
+	// tail is the last node, unless a producer already swapped the head
+	if (p_tail != lane.m_head.loadAcquire())
+	{
+		isBlocked = true;
+		return nullptr;
+	}
+	// re-insert stub so the last node can be unlinked
+	QEventMailbox::push(lane, &lane.m_stub);
+	p_next = p_tail->m_next.loadAcquire();
+	if (p_next)
+	{
+		lane.mp_tail = p_next;
+		return p_tail;
+	}
+	isBlocked = true;
+	return nullptr;
+}
+
+QEventMailboxNode * QEventMailbox::takeNext(bool &isBlocked)
+{
+	isBlocked = false;
+	// first pass skips lanes that already had their streak, second pass takes whatever is there
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int i = 0; i < m_laneCount; i++)
+		{
+			Lane &currLane = mp_lanes[i];
+			if (pass == 0 && m_maxStreak > 0 && currLane.m_streak >= m_maxStreak)
+			{
+				continue;
+			}
+			bool isLaneBlocked = false;
+			QEventMailboxNode * p_node = QEventMailbox::pop(currLane, isLaneBlocked);
+			isBlocked = isBlocked || isLaneBlocked;
+			if (!p_node)
+			{
+				continue;
+			}
+			currLane.m_depth.fetchAndAddOrdered(-1);
+			// lower lanes waited for this one (if any), higher lanes gave way
+			if (i < m_laneCount - 1)
+			{
+				currLane.m_streak++;
+			}
+			for (int j = 0; j < i; j++)
+			{
+				mp_lanes[j].m_streak = 0;
+			}
+			return p_node;
+		}
+	}
+	return nullptr;
+}
+
+void QEventMailbox::schedule(Lane &lane)
+{
+	if (!lane.m_scheduled.testAndSetOrdered(0, 1))
+	{
+		return;
+	}
+	// event loop takes ownership of the event and deletes it later
+	QCoreApplication::postEvent(mp_receiver, new QEvent(m_wakeupType), lane.m_priority);
+}
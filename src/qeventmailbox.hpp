@@ -0,0 +1,141 @@
+#ifndef QEVENTMAILBOX_H
+#define QEVENTMAILBOX_H
+
+#include <QCoreApplication>
+#include <QObject>
+#include <QEvent>
+#include <QList>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// base class of the mailbox queue nodes, derived classes contain the actual task
+class QEventMailboxNode
+{
+public:
+	QEventMailboxNode();
+	virtual ~QEventMailboxNode();
+
+	virtual void exec() = 0;
+
+private:
+	// make friend, so it can link the nodes
+	friend class QEventMailbox;
+	QAtomicPointer<QEventMailboxNode> m_next;
+};
+
+// node containing any callable, so queueing a task takes a single allocation
+template<typename F>
+class QEventMailboxTask : public QEventMailboxNode
+{
+public:
+	explicit QEventMailboxTask(F &&func) : m_func(std::move(func)) { }
+	explicit QEventMailboxTask(const F &func) : m_func(func) { }
+
+	void exec() { m_func(); }
+
+private:
+	F m_func;
+};
+
+// intrusive lock-free multiple producer single consumer queue of tasks to be executed in the receiver's thread
+// NOTE : * instead of posting one event per task (which locks the receiving thread's event queue and wakes
+//          its event dispatcher every time), a single wakeup event is posted on the empty -> non-empty transition
+//        * the receiver must call drain() when it gets the wakeup event, tasks are executed in posting order
+//        * tasks can be split in lanes (0 is the most important), drain() serves higher lanes first but after
+//          maxStreak tasks in a row from a lane, lower lanes get one turn so they cannot be starved forever
+//          (maxStreak 0 for strict priority)
+//        * based on Dmitry Vyukov's intrusive MPSC node-based queue
+class QEventMailbox
+{
+public:
+	// single lane mailbox, wakeup event posted with given priority
+	QEventMailbox(QObject * p_receiver, QEvent::Type wakeupType, int priority = Qt::NormalEventPriority);
+	// one lane per priority (sorted highest first), wakeup event of each lane posted with its priority
+	QEventMailbox(QObject * p_receiver, QEvent::Type wakeupType, const QList<int> &lanePriorities, int maxStreak = 16);
+	~QEventMailbox();
+
+	// producer API (any thread)
+
+	// queue callable
+	template<typename F>
+	void post(F &&func, int lane = 0);
+	// queue node (mailbox takes ownership)
+	void postNode(QEventMailboxNode * p_node, int lane = 0);
+
+	// consumer API (receiver's thread)
+
+	// execute queued tasks, returns number of tasks executed
+	// NOTE : at most maxTasks are executed, then a new wakeup is posted so other events are not starved,
+	//        same if p_interrupt is set (non-zero) by another thread while draining
+	int  drain(int maxTasks = 1024, const QAtomicInt * p_interrupt = nullptr);
+	// called by a task being drained, stops the drain after it and posts a new wakeup,
+	// so the event loop of the receiver's thread runs (timers, other events) before the rest
+	void yield();
+	// delete queued tasks without executing them, returns number of tasks deleted
+	int  discard();
+
+	// metrics (any thread)
+
+	// number of lanes
+	int  laneCount() const;
+	// priority of a lane
+	int  lanePriority(int lane) const;
+	// tasks currently queued in a lane
+	int  depth(int lane) const;
+	// maximum number of tasks ever queued at the same time in a lane
+	int  maxDepth(int lane) const;
+
+private:
+	Q_DISABLE_COPY(QEventMailbox)
+	// empty node to keep the queue linked when there are no tasks
+	class StubNode : public QEventMailboxNode
+	{
+	public:
+		void exec() { }
+	};
+	// one queue per lane
+	struct Lane
+	{
+		Lane();
+		// producers end
+		QAtomicPointer<QEventMailboxNode> m_head;
+		// consumer end (only touched by the receiver's thread)
+		QEventMailboxNode               * mp_tail;
+		StubNode                          m_stub;
+		// 1 if a wakeup event is pending
+		QAtomicInt                        m_scheduled;
+		// priority of the wakeup event
+		int                               m_priority;
+		// metrics
+		QAtomicInt                        m_depth;
+		QAtomicInt                        m_maxDepth;
+		// tasks served in a row while lower lanes had to wait (only touched by the receiver's thread)
+		int                               m_streak;
+	};
+	QObject    * mp_receiver;
+	QEvent::Type m_wakeupType;
+	Lane       * mp_lanes;
+	int          m_laneCount;
+	int          m_maxStreak;
+	// set by yield() (only touched by the receiver's thread)
+	bool         m_yieldRequested;
+	// link node at the producers end
+	static void push(Lane &lane, QEventMailboxNode * p_node);
+	// unlink node at the consumer end, nullptr if empty or if a producer is in the middle of a push
+	static QEventMailboxNode * pop(Lane &lane, bool &isBlocked);
+	// unlink next node to be executed, according to lane priority and streaks
+	QEventMailboxNode * takeNext(bool &isBlocked);
+	// post wakeup event if none pending
+	void schedule(Lane &lane);
+};
+
+template<typename F>
+void QEventMailbox::post(F &&func, int lane/* = 0*/)
+{
+	this->postNode(new QEventMailboxTask<typename std::decay<F>::type>(std::forward<F>(func)), lane);
+}
+
+#endif // QEVENTMAILBOX_H
@@ -0,0 +1,10 @@
+CONFIG += c++11
+CONFIG -= flat
+
+INCLUDEPATH += $$PWD/
+
+HEADERS     += $$PWD/qeventmailbox.hpp
+
+SOURCES     += $$PWD/qeventmailbox.cpp
+
+DEFINES     += QEVENTMAILBOX_USED
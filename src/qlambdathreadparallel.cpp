@@ -0,0 +1,36 @@
+#include "qlambdathreadparallel.h"
+
+QLambdaThreadParallel::QLambdaThreadParallel(const QLambdaThreadPool &pool) : m_data(nullptr)
+{
+	m_data = QExplicitlySharedDataPointer<QLambdaThreadParallelData>(new QLambdaThreadParallelData(pool));
+}
+
+QLambdaThreadParallel::QLambdaThreadParallel(const QList<QLambdaThreadWorker> &listWorkers) : m_data(nullptr)
+{
+	m_data = QExplicitlySharedDataPointer<QLambdaThreadParallelData>(new QLambdaThreadParallelData(listWorkers));
+}
+
+QLambdaThreadParallel::QLambdaThreadParallel(const QLambdaThreadParallel &other) : m_data(other.m_data)
+{
+	m_data.reset();
+	m_data = other.m_data;
+}
+
+QLambdaThreadParallel & QLambdaThreadParallel::operator=(const QLambdaThreadParallel &rhs)
+{
+	if (this != &rhs) {
+		m_data.reset();
+		m_data.operator=(rhs.m_data);
+	}
+	return *this;
+}
+
+QLambdaThreadParallel::~QLambdaThreadParallel()
+{
+	m_data.reset();
+}
+
+int QLambdaThreadParallel::getThreadCount() const
+{
+	return m_data->getThreadCount();
+}
@@ -0,0 +1,209 @@
+#ifndef QLAMBDATHREADPARALLEL_H
+#define QLAMBDATHREADPARALLEL_H
+
+#include <QExplicitlySharedDataPointer>
+#include <QSharedPointer>
+#include <QVector>
+#include <QDeferred>
+#include <exception>
+#include <type_traits>
+#include "qlambdathreadparalleldata.h"
+
+// state of a parallelFor call, shared by its tasks
+template<typename F>
+struct QLambdaThreadParallelForState
+{
+	QLambdaThreadParallelForState(const qint64 &intBegin, const qint64 &intEnd, const qint64 &intGrain, const int &intTaskCount, F &&func) :
+		m_range(intBegin, intEnd, intGrain, intTaskCount),
+		m_func(std::forward<F>(func))
+	{ }
+
+	void execChunk(const qint64 &intChunkBegin, const qint64 &intChunkEnd)
+	{
+		for (qint64 i = intChunkBegin; i < intChunkEnd; i++)
+		{
+			m_func(i);
+		}
+	}
+
+	void settle()
+	{
+		if (m_range.isCancelled())
+		{
+			m_defer.reject();
+			return;
+		}
+		m_defer.resolve();
+	}
+
+	QLambdaThreadParallelRange       m_range;
+	typename std::decay<F>::type     m_func;
+	QDefer                           m_defer;
+};
+
+// state of a parallelMap call, results are written in place so a chunk does not allocate per element
+template<typename C, typename F, typename R>
+struct QLambdaThreadParallelMapState
+{
+	QLambdaThreadParallelMapState(const C &container, const qint64 &intGrain, const int &intTaskCount, F &&func) :
+		m_range(0, (qint64)container.size(), intGrain, intTaskCount),
+		m_func(std::forward<F>(func)),
+		m_container(container)
+	{
+		m_results.resize((int)container.size());
+		// detach once here, tasks write to disjoint elements
+		mp_results = m_results.data();
+	}
+
+	void execChunk(const qint64 &intChunkBegin, const qint64 &intChunkEnd)
+	{
+		for (qint64 i = intChunkBegin; i < intChunkEnd; i++)
+		{
+			mp_results[i] = m_func(m_container[i]);
+		}
+	}
+
+	void settle()
+	{
+		if (m_range.isCancelled())
+		{
+			m_defer.reject(QVector<R>());
+			return;
+		}
+		m_defer.resolve(m_results);
+	}
+
+	QLambdaThreadParallelRange       m_range;
+	typename std::decay<F>::type     m_func;
+	const C                          m_container;
+	QVector<R>                       m_results;
+	R *                              mp_results;
+	QDeferred<QVector<R>>            m_defer;
+};
+
+// result type of parallelMap
+template<typename C, typename F>
+struct QLambdaThreadParallelMapResult
+{
+	typedef typename std::decay<typename std::result_of<F(const typename C::value_type &)>::type>::type Type;
+};
+
+// data parallel calls over a pool or a set of workers, returning a deferred
+// NOTE : * the range is split in chunks grabbed by one task per thread (guided chunking), so threads that
+//          finish early take more work, a chunk never has less than intGrain elements (except the last one)
+//        * the function is called concurrently from several threads, it must be safe to do so
+//        * if the function throws no more chunks are handed out and the deferred is rejected
+//        * the deferred is resolved in a thread of the workers, callbacks run in the thread they were registered in
+class QLambdaThreadParallel
+{
+public:
+	// constructors
+	QLambdaThreadParallel(const QLambdaThreadPool &pool);
+	QLambdaThreadParallel(const QList<QLambdaThreadWorker> &listWorkers);
+	QLambdaThreadParallel(const QLambdaThreadParallel &other);
+	QLambdaThreadParallel &operator=(const QLambdaThreadParallel &rhs);
+	~QLambdaThreadParallel();
+
+	int getThreadCount() const;
+
+	// call func(qint64 index) for each index in [intBegin, intEnd)
+	template<typename F>
+	QDefer parallelFor(const qint64 &intBegin, const qint64 &intEnd, const qint64 &intGrain, F &&func);
+
+	// call func(element) for each element of a random access container (QVector, QList, std::vector, etc.),
+	// resolved with the results in the same order
+	template<typename C, typename F>
+	QDeferred<QVector<typename QLambdaThreadParallelMapResult<C, F>::Type>> parallelMap(const C &container, F &&func, const qint64 &intGrain = 1);
+
+protected:
+	QExplicitlySharedDataPointer<QLambdaThreadParallelData> m_data;
+
+	// queue one task per thread over the state's range
+	template<typename S>
+	void execTasks(const QSharedPointer<S> &p_state);
+	// grab and execute chunks until range exhausted (runs in worker's thread)
+	template<typename S>
+	static void execTask(const QSharedPointer<S> &p_state);
+};
+
+template<typename F>
+QDefer QLambdaThreadParallel::parallelFor(const qint64 &intBegin, const qint64 &intEnd, const qint64 &intGrain, F &&func)
+{
+	int intTaskCount = QLambdaThreadParallelRange::taskCountFor(intBegin, intEnd, intGrain, m_data->getThreadCount());
+	if (intTaskCount == 0)
+	{
+		QDefer retDefer;
+		retDefer.resolve();
+		return retDefer;
+	}
+	QSharedPointer<QLambdaThreadParallelForState<F>> p_state(new QLambdaThreadParallelForState<F>(intBegin, intEnd, intGrain, intTaskCount, std::forward<F>(func)));
+	this->execTasks(p_state);
+	return p_state->m_defer;
+}
+
+template<typename C, typename F>
+QDeferred<QVector<typename QLambdaThreadParallelMapResult<C, F>::Type>> QLambdaThreadParallel::parallelMap(const C &container, F &&func, const qint64 &intGrain/* = 1*/)
+{
+	typedef typename QLambdaThreadParallelMapResult<C, F>::Type R;
+	int intTaskCount = QLambdaThreadParallelRange::taskCountFor(0, (qint64)container.size(), intGrain, m_data->getThreadCount());
+	if (intTaskCount == 0)
+	{
+		QDeferred<QVector<R>> retDefer;
+		retDefer.resolve(QVector<R>());
+		return retDefer;
+	}
+	QSharedPointer<QLambdaThreadParallelMapState<C, F, R>> p_state(new QLambdaThreadParallelMapState<C, F, R>(container, intGrain, intTaskCount, std::forward<F>(func)));
+	this->execTasks(p_state);
+	return p_state->m_defer;
+}
+
+template<typename S>
+void QLambdaThreadParallel::execTasks(const QSharedPointer<S> &p_state)
+{
+	for (int i = 0; i < p_state->m_range.taskCount(); i++)
+	{
+		if (m_data->execInThread([p_state]() {
+			QLambdaThreadParallel::execTask(p_state);
+		}, i))
+		{
+			continue;
+		}
+		// worker quitting, task never executed
+		p_state->m_range.cancel();
+		if (p_state->m_range.finishTask())
+		{
+			p_state->settle();
+		}
+	}
+}
+
+template<typename S>
+void QLambdaThreadParallel::execTask(const QSharedPointer<S> &p_state)
+{
+	qint64 intChunkBegin = 0;
+	qint64 intChunkEnd   = 0;
+	// exceptions must not leave the event loop, cancel instead
+	try
+	{
+		while (p_state->m_range.nextChunk(intChunkBegin, intChunkEnd))
+		{
+			p_state->execChunk(intChunkBegin, intChunkEnd);
+		}
+	}
+	catch (const std::exception &e)
+	{
+		qWarning() << "QLambdaThreadParallel : Exception thrown," << e.what();
+		p_state->m_range.cancel();
+	}
+	catch (...)
+	{
+		qWarning() << "QLambdaThreadParallel : Unknown exception thrown.";
+		p_state->m_range.cancel();
+	}
+	if (p_state->m_range.finishTask())
+	{
+		p_state->settle();
+	}
+}
+
+#endif // QLAMBDATHREADPARALLEL_H
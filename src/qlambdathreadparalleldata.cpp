@@ -0,0 +1,110 @@
+#include "qlambdathreadparalleldata.h"
+
+QLambdaThreadParallelRange::QLambdaThreadParallelRange(const qint64 &intBegin, const qint64 &intEnd, const qint64 &intGrain, const int &intTaskCount) :
+	m_intEnd(intEnd),
+	m_intGrain(qMax(intGrain, (qint64)1)),
+	m_intTaskCount(qMax(intTaskCount, 1)),
+	m_next(intBegin),
+	m_pending(qMax(intTaskCount, 1)),
+	m_cancelled(0)
+{
+
+}
+
+bool QLambdaThreadParallelRange::nextChunk(qint64 &intChunkBegin, qint64 &intChunkEnd)
+{
+	qint64 current = m_next.loadAcquire();
+	forever
+	{
+		if (current >= m_intEnd || m_cancelled.loadAcquire() != 0)
+		{
+			return false;
+		}
+		qint64 remaining = m_intEnd - current;
+		qint64 size      = qMin(remaining, qMax(m_intGrain, remaining / (m_intTaskCount * QLAMBDATHREADPARALLEL_CHUNKS_PER_TASK)));
+		if (m_next.testAndSetOrdered(current, current + size, current))
+		{
+			intChunkBegin = current;
+			intChunkEnd   = current + size;
+			return true;
+		}
+	}
+}
+
+void QLambdaThreadParallelRange::cancel()
+{
+	m_cancelled.storeRelease(1);
+}
+
+bool QLambdaThreadParallelRange::isCancelled() const
+{
+	return m_cancelled.loadAcquire() != 0;
+}
+
+bool QLambdaThreadParallelRange::finishTask()
+{
+	return m_pending.fetchAndSubOrdered(1) == 1;
+}
+
+int QLambdaThreadParallelRange::taskCount() const
+{
+	return m_intTaskCount;
+}
+
+int QLambdaThreadParallelRange::taskCountFor(const qint64 &intBegin, const qint64 &intEnd, const qint64 &intGrain, const int &intThreadCount)
+{
+	if (intEnd <= intBegin)
+	{
+		return 0;
+	}
+	qint64 grain  = qMax(intGrain, (qint64)1);
+	qint64 chunks = (intEnd - intBegin + grain - 1) / grain;
+	return (int)qMin(chunks, (qint64)qMax(intThreadCount, 1));
+}
+
+QLambdaThreadParallelData::QLambdaThreadParallelData(const QLambdaThreadPool &pool) :
+	m_intThreadCount(0)
+{
+	m_pool.append(pool);
+	m_intThreadCount = m_pool.first().getThreadCount();
+}
+
+QLambdaThreadParallelData::QLambdaThreadParallelData(const QList<QLambdaThreadWorker> &listWorkers) :
+	m_workers(listWorkers),
+	m_intThreadCount(listWorkers.count())
+{
+	Q_ASSERT_X(!listWorkers.isEmpty(), "QLambdaThreadParallel", "At least one worker is required.");
+}
+
+QLambdaThreadParallelData::QLambdaThreadParallelData(const QLambdaThreadParallelData &other) :
+	QSharedData(other),
+	m_pool(other.m_pool),
+	m_workers(other.m_workers),
+	m_intThreadCount(other.m_intThreadCount)
+{
+
+}
+
+QLambdaThreadParallelData::~QLambdaThreadParallelData()
+{
+
+}
+
+int QLambdaThreadParallelData::getThreadCount() const
+{
+	return m_intThreadCount;
+}
+
+bool QLambdaThreadParallelData::execInThread(const std::function<void()> &threadFunc, const int &intTaskIndex)
+{
+	// pool balances tasks by itself (work stealing)
+	if (!m_pool.isEmpty())
+	{
+		return m_pool.first().execInThread(threadFunc);
+	}
+	if (m_workers.isEmpty())
+	{
+		return false;
+	}
+	return m_workers[intTaskIndex % m_workers.count()].execInThread(threadFunc);
+}
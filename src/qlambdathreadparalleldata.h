@@ -0,0 +1,70 @@
+#ifndef QLAMBDATHREADPARALLELDATA_H
+#define QLAMBDATHREADPARALLELDATA_H
+
+#include <QSharedData>
+#include <QAtomicInteger>
+#include <QAtomicInt>
+#include <QList>
+#include <functional>
+
+#include "qlambdathreadworker.h"
+#include "qlambdathreadpool.h"
+
+// number of chunks each task aims for, smaller chunks balance better but grab the shared range more often
+#define QLAMBDATHREADPARALLEL_CHUNKS_PER_TASK 4
+
+// QLAMBDATHREADPARALLELRANGE -------------------------------------------------
+
+// range shared by the tasks of a parallel call, each task grabs chunks until the range is exhausted
+// NOTE : guided chunking, chunk size is proportional to what is left so the first chunks are large (few atomic
+//        operations) and the last ones small (threads finish together), but never smaller than the grain
+class QLambdaThreadParallelRange
+{
+public:
+	QLambdaThreadParallelRange(const qint64 &intBegin, const qint64 &intEnd, const qint64 &intGrain, const int &intTaskCount);
+
+	// take next chunk, false if the range is exhausted or cancelled
+	bool nextChunk(qint64 &intChunkBegin, qint64 &intChunkEnd);
+	// stop handing out chunks (e.g. an element threw)
+	void cancel();
+	bool isCancelled() const;
+	// mark task as finished, true for the last one
+	bool finishTask();
+
+	int  taskCount() const;
+
+	// number of tasks needed for a range
+	static int taskCountFor(const qint64 &intBegin, const qint64 &intEnd, const qint64 &intGrain, const int &intThreadCount);
+
+private:
+	qint64                  m_intEnd;
+	qint64                  m_intGrain;
+	int                     m_intTaskCount;
+	QAtomicInteger<qint64>  m_next;
+	QAtomicInt              m_pending;
+	QAtomicInt              m_cancelled;
+};
+
+// QLAMBDATHREADPARALLELDATA --------------------------------------------------
+
+class QLambdaThreadParallelData : public QSharedData
+{
+public:
+	QLambdaThreadParallelData(const QLambdaThreadPool &pool);
+	QLambdaThreadParallelData(const QList<QLambdaThreadWorker> &listWorkers);
+	QLambdaThreadParallelData(const QLambdaThreadParallelData &other);
+	~QLambdaThreadParallelData();
+
+	int  getThreadCount() const;
+
+	// queue task of a parallel call, spread over the workers
+	bool execInThread(const std::function<void()> &threadFunc, const int &intTaskIndex);
+
+private:
+	// NOTE : list with one pool or empty, a default constructed pool would start its own threads
+	QList<QLambdaThreadPool>   m_pool;
+	QList<QLambdaThreadWorker> m_workers;
+	int                        m_intThreadCount;
+};
+
+#endif // QLAMBDATHREADPARALLELDATA_H
@@ -0,0 +1,290 @@
+#ifndef QLAMBDATHREADPIPELINE_H
+#define QLAMBDATHREADPIPELINE_H
+
+#include <QExplicitlySharedDataPointer>
+#include <QDeferred>
+#include <QDebug>
+#include <type_traits>
+#include <exception>
+#include "qlambdathreadpipelinedata.h"
+
+// QLAMBDATHREADSTAGEDATA -----------------------------------------------------
+
+template<typename In>
+class QLambdaThreadStageData : public QLambdaThreadStageBase
+{
+public:
+	QLambdaThreadStageData(const QLambdaThreadStageExecutor &executor, const int &intCapacity) :
+		QLambdaThreadStageBase(executor),
+		m_ring(intCapacity)
+	{ }
+
+	// false if full
+	bool tryPush(const In &item)
+	{
+		if (!m_ring.push(item))
+		{
+			return false;
+		}
+		this->afterPush();
+		return true;
+	}
+
+	bool push(const In &item)
+	{
+		if (this->tryPush(item))
+		{
+			return true;
+		}
+		m_rejected.fetchAndAddRelaxed(1);
+		return false;
+	}
+
+	bool pushBlocking(const In &item, const int &msTimeout)
+	{
+		if (this->tryPush(item))
+		{
+			return true;
+		}
+		return this->waitForRoom([this, &item]() {
+			return this->tryPush(item);
+		}, msTimeout);
+	}
+
+	int  occupancy() const { return m_ring.count(); }
+	int  capacity() const { return m_ring.capacity(); }
+	bool isFull() const { return m_ring.isFull(); }
+
+	// stage function, processes an item and sends the result to the output (if any)
+	std::function<void(In &)> m_processFunc;
+
+protected:
+	DrainResult drainBatch(const int &intMaxItems)
+	{
+		for (int i = 0; i < intMaxItems; i++)
+		{
+			// result of the previous item must go downstream first, keeps order and bounds memory
+			if (mp_output && !mp_output->flush())
+			{
+				return Blocked;
+			}
+			In item;
+			if (!m_ring.pop(item))
+			{
+				return Empty;
+			}
+			this->afterPop();
+			qint64 startNs = m_clock.nsecsElapsed();
+			// NOTE : an exception must not unwind out of the drain, the stage would stay scheduled forever
+			try
+			{
+				m_processFunc(item);
+			}
+			catch (const std::exception &e)
+			{
+				qWarning() << "QLambdaThreadStage : Exception thrown," << e.what();
+				m_failed.fetchAndAddRelaxed(1);
+			}
+			catch (...)
+			{
+				qWarning() << "QLambdaThreadStage : Unknown exception thrown.";
+				m_failed.fetchAndAddRelaxed(1);
+			}
+			m_busyNs.fetchAndAddRelaxed(m_clock.nsecsElapsed() - startNs);
+			m_processed.fetchAndAddRelaxed(1);
+		}
+		return Yield;
+	}
+
+	bool hasWork() const
+	{
+		if (mp_output && mp_output->hasPending())
+		{
+			return mp_output->canFlush();
+		}
+		return !m_ring.isEmpty();
+	}
+
+private:
+	QLambdaThreadRing<In> m_ring;
+};
+
+// QLAMBDATHREADSTAGEOUTPUT ---------------------------------------------------
+
+template<typename Out>
+class QLambdaThreadStageOutput : public QLambdaThreadStageOutputBase
+{
+public:
+	// NOTE : upstream owns the output, so a raw pointer to it is safe
+	QLambdaThreadStageOutput(QLambdaThreadStageBase * p_upstream, const QExplicitlySharedDataPointer<QLambdaThreadStageData<Out>> &p_downstream) :
+		mp_upstream(p_upstream),
+		mp_downstream(p_downstream),
+		m_hasPending(false)
+	{ }
+
+	// keep result until flushed downstream
+	void send(Out &&item)
+	{
+		m_pending    = std::move(item);
+		m_hasPending = true;
+	}
+
+	bool flush()
+	{
+		if (!m_hasPending)
+		{
+			return true;
+		}
+		if (!mp_downstream->tryPush(m_pending))
+		{
+			// register and retry, room made in between would otherwise go unnoticed
+			mp_downstream->addWaitingUpstream(mp_upstream);
+			if (!mp_downstream->tryPush(m_pending))
+			{
+				return false;
+			}
+		}
+		m_pending    = Out();
+		m_hasPending = false;
+		return true;
+	}
+
+	bool canFlush() const
+	{
+		return m_hasPending && !mp_downstream->isFull();
+	}
+
+	bool hasPending() const
+	{
+		return m_hasPending;
+	}
+
+private:
+	QLambdaThreadStageBase                                  * mp_upstream;
+	QExplicitlySharedDataPointer<QLambdaThreadStageData<Out>> mp_downstream;
+	Out                                                       m_pending;
+	bool                                                      m_hasPending;
+};
+
+// QLAMBDATHREADSTAGE ---------------------------------------------------------
+
+// stage of a pipeline, items pushed to it are processed in order by its function in a worker (or any
+// thread of a pool, one at a time), and the results pushed to the downstream stage
+// NOTE : * items are queued in a bounded lock-free ring, producers get a rejected push (or block) when it is full
+//        * when the downstream stage is full, a stage keeps its last result and stops taking items until
+//          downstream makes room, so backpressure propagates up to the producers without unbounded queues
+//        * several stages (and producers) can push to the same stage, items are processed in push order
+//        * pushBlocking must not be called from the thread of a downstream stage (it would wait for itself)
+template<typename In>
+class QLambdaThreadStage
+{
+public:
+	// sink stage, func(const In &) results are discarded
+	template<typename F>
+	QLambdaThreadStage(const QLambdaThreadStageExecutor &executor, F &&func, const int &intCapacity = QLAMBDATHREADSTAGE_CAPACITY);
+	// transform stage, func(const In &) results are pushed to downstream
+	template<typename F, typename Out>
+	QLambdaThreadStage(const QLambdaThreadStageExecutor &executor, F &&func, const QLambdaThreadStage<Out> &downstream, const int &intCapacity = QLAMBDATHREADSTAGE_CAPACITY);
+	QLambdaThreadStage(const QLambdaThreadStage &other);
+	QLambdaThreadStage &operator=(const QLambdaThreadStage &rhs);
+	~QLambdaThreadStage();
+
+	// queue item, false if full (not counted as rejected)
+	bool   tryPush(const In &item);
+
+	// queue item, deferred rejected if full
+	QDefer push(const In &item);
+
+	// queue item, waits for room up to msTimeout (forever if negative), false on timeout
+	bool   pushBlocking(const In &item, const int &msTimeout = -1);
+
+	// safe to call from any thread
+	QLambdaThreadStageMetrics getMetrics() const;
+
+protected:
+	QExplicitlySharedDataPointer<QLambdaThreadStageData<In>> m_data;
+
+	template<typename> friend class QLambdaThreadStage;
+};
+
+template<typename In>
+template<typename F>
+QLambdaThreadStage<In>::QLambdaThreadStage(const QLambdaThreadStageExecutor &executor, F &&func, const int &intCapacity/* = QLAMBDATHREADSTAGE_CAPACITY*/) : m_data(nullptr)
+{
+	m_data = QExplicitlySharedDataPointer<QLambdaThreadStageData<In>>(new QLambdaThreadStageData<In>(executor, intCapacity));
+	typename std::decay<F>::type stageFunc(std::forward<F>(func));
+	m_data->m_processFunc = [stageFunc](In &item) mutable {
+		stageFunc(static_cast<const In &>(item));
+	};
+}
+
+template<typename In>
+template<typename F, typename Out>
+QLambdaThreadStage<In>::QLambdaThreadStage(const QLambdaThreadStageExecutor &executor, F &&func, const QLambdaThreadStage<Out> &downstream, const int &intCapacity/* = QLAMBDATHREADSTAGE_CAPACITY*/) : m_data(nullptr)
+{
+	m_data = QExplicitlySharedDataPointer<QLambdaThreadStageData<In>>(new QLambdaThreadStageData<In>(executor, intCapacity));
+	auto p_output = new QLambdaThreadStageOutput<Out>(m_data.data(), downstream.m_data);
+	m_data->setOutput(p_output);
+	typename std::decay<F>::type stageFunc(std::forward<F>(func));
+	m_data->m_processFunc = [p_output, stageFunc](In &item) mutable {
+		p_output->send(Out(stageFunc(static_cast<const In &>(item))));
+	};
+}
+
+template<typename In>
+QLambdaThreadStage<In>::QLambdaThreadStage(const QLambdaThreadStage<In> &other) : m_data(other.m_data)
+{
+	m_data.reset();
+	m_data = other.m_data;
+}
+
+template<typename In>
+QLambdaThreadStage<In> & QLambdaThreadStage<In>::operator=(const QLambdaThreadStage<In> &rhs)
+{
+	if (this != &rhs) {
+		m_data.reset();
+		m_data.operator=(rhs.m_data);
+	}
+	return *this;
+}
+
+template<typename In>
+QLambdaThreadStage<In>::~QLambdaThreadStage()
+{
+	m_data.reset();
+}
+
+template<typename In>
+bool QLambdaThreadStage<In>::tryPush(const In &item)
+{
+	return m_data->tryPush(item);
+}
+
+template<typename In>
+QDefer QLambdaThreadStage<In>::push(const In &item)
+{
+	QDefer retDefer;
+	if (m_data->push(item))
+	{
+		retDefer.resolve();
+	}
+	else
+	{
+		retDefer.reject();
+	}
+	return retDefer;
+}
+
+template<typename In>
+bool QLambdaThreadStage<In>::pushBlocking(const In &item, const int &msTimeout/* = -1*/)
+{
+	return m_data->pushBlocking(item, msTimeout);
+}
+
+template<typename In>
+QLambdaThreadStageMetrics QLambdaThreadStage<In>::getMetrics() const
+{
+	return m_data->getMetrics();
+}
+
+#endif // QLAMBDATHREADPIPELINE_H
@@ -0,0 +1,231 @@
+#include "qlambdathreadpipelinedata.h"
+#include <atomic>
+
+// QLAMBDATHREADSTAGEEXECUTOR -------------------------------------------------
+
+QLambdaThreadStageExecutor::QLambdaThreadStageExecutor(const QLambdaThreadWorker &worker)
+{
+	QLambdaThreadWorker stageWorker = worker;
+	m_execFunc = [stageWorker](const std::function<void()> &threadFunc) mutable {
+		return stageWorker.execInThread(threadFunc);
+	};
+}
+
+QLambdaThreadStageExecutor::QLambdaThreadStageExecutor(const QLambdaThreadPool &pool)
+{
+	QLambdaThreadPool stagePool = pool;
+	m_execFunc = [stagePool](const std::function<void()> &threadFunc) mutable {
+		return stagePool.execInThread(threadFunc);
+	};
+}
+
+bool QLambdaThreadStageExecutor::execInThread(const std::function<void()> &threadFunc) const
+{
+	return m_execFunc(threadFunc);
+}
+
+// QLAMBDATHREADSTAGEOUTPUTBASE -----------------------------------------------
+
+QLambdaThreadStageOutputBase::~QLambdaThreadStageOutputBase()
+{
+
+}
+
+// QLAMBDATHREADSTAGEBASE -----------------------------------------------------
+
+QLambdaThreadStageBase::QLambdaThreadStageBase(const QLambdaThreadStageExecutor &executor) :
+	mp_output(nullptr),
+	m_processed(0),
+	m_failed(0),
+	m_rejected(0),
+	m_blocked(0),
+	m_busyNs(0),
+	m_executor(executor),
+	m_scheduled(0),
+	m_maxOccupancy(0),
+	m_firstPushNs(-1),
+	m_blockedProducers(0),
+	m_hasWaitingUpstream(0)
+{
+	m_clock.start();
+}
+
+QLambdaThreadStageBase::QLambdaThreadStageBase(const QLambdaThreadStageBase &other) :
+	QSharedData(other),
+	mp_output(nullptr),
+	m_processed(0),
+	m_failed(0),
+	m_rejected(0),
+	m_blocked(0),
+	m_busyNs(0),
+	m_executor(other.m_executor),
+	m_scheduled(0),
+	m_maxOccupancy(0),
+	m_firstPushNs(-1),
+	m_blockedProducers(0),
+	m_hasWaitingUpstream(0)
+{
+	m_clock.start();
+}
+
+QLambdaThreadStageBase::~QLambdaThreadStageBase()
+{
+	delete mp_output;
+	mp_output = nullptr;
+}
+
+QLambdaThreadStageMetrics QLambdaThreadStageBase::getMetrics() const
+{
+	QLambdaThreadStageMetrics metrics;
+	metrics.processed    = m_processed.loadAcquire();
+	metrics.failed       = m_failed.loadAcquire();
+	metrics.rejected     = m_rejected.loadAcquire();
+	metrics.blocked      = m_blocked.loadAcquire();
+	metrics.occupancy    = this->occupancy();
+	metrics.maxOccupancy = m_maxOccupancy.loadAcquire();
+	metrics.capacity     = this->capacity();
+	metrics.busyNs       = m_busyNs.loadAcquire();
+	metrics.throughput   = 0.0;
+	qint64 firstPushNs   = m_firstPushNs.loadAcquire();
+	qint64 elapsedNs     = m_clock.nsecsElapsed() - firstPushNs;
+	if (firstPushNs >= 0 && elapsedNs > 0)
+	{
+		metrics.throughput = (double)metrics.processed * 1e9 / (double)elapsedNs;
+	}
+	return metrics;
+}
+
+void QLambdaThreadStageBase::scheduleDrain()
+{
+	if (!m_scheduled.testAndSetOrdered(0, 1))
+	{
+		return;
+	}
+	QExplicitlySharedDataPointer<QLambdaThreadStageBase> p_self(this);
+	if (!m_executor.execInThread([p_self]() {
+		p_self->drain();
+	}))
+	{
+		// executor quitting, items stay queued
+		m_scheduled.storeRelease(0);
+	}
+}
+
+void QLambdaThreadStageBase::addWaitingUpstream(QLambdaThreadStageBase * p_upstream)
+{
+	m_blocked.fetchAndAddRelaxed(1);
+	{
+		QMutexLocker locker(&m_roomMutex);
+		m_listWaitingUpstream.append(QExplicitlySharedDataPointer<QLambdaThreadStageBase>(p_upstream));
+		m_hasWaitingUpstream.storeRelease(1);
+	}
+	// NOTE : pairs with the fence in afterPop, either the upstream retry sees the room or afterPop sees the flag
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void QLambdaThreadStageBase::afterPush()
+{
+	if (m_firstPushNs.loadAcquire() < 0)
+	{
+		m_firstPushNs.testAndSetOrdered(-1, m_clock.nsecsElapsed());
+	}
+	int intOccupancy = this->occupancy();
+	int intMax       = m_maxOccupancy.loadAcquire();
+	while (intOccupancy > intMax && !m_maxOccupancy.testAndSetOrdered(intMax, intOccupancy, intMax))
+	{
+		// retry with updated maximum
+	}
+	this->scheduleDrain();
+}
+
+void QLambdaThreadStageBase::afterPop()
+{
+	// NOTE : a producer registers (flag or counter) before retrying its push, so with both fences in place
+	//        it cannot miss this pop while this pop misses its registration
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_hasWaitingUpstream.loadAcquire() != 0)
+	{
+		QList<QExplicitlySharedDataPointer<QLambdaThreadStageBase>> listWaiting;
+		{
+			QMutexLocker locker(&m_roomMutex);
+			listWaiting.swap(m_listWaitingUpstream);
+			m_hasWaitingUpstream.storeRelease(0);
+		}
+		for (int i = 0; i < listWaiting.count(); i++)
+		{
+			listWaiting[i]->scheduleDrain();
+		}
+	}
+	if (m_blockedProducers.loadAcquire() > 0)
+	{
+		QMutexLocker locker(&m_roomMutex);
+		m_roomCondition.wakeAll();
+	}
+}
+
+bool QLambdaThreadStageBase::waitForRoom(const std::function<bool()> &tryPushFunc, const int &msTimeout)
+{
+	QElapsedTimer timer;
+	timer.start();
+	m_blocked.fetchAndAddRelaxed(1);
+	m_blockedProducers.fetchAndAddOrdered(1);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	bool pushed = false;
+	{
+		QMutexLocker locker(&m_roomMutex);
+		forever
+		{
+			if (tryPushFunc())
+			{
+				pushed = true;
+				break;
+			}
+			if (msTimeout < 0)
+			{
+				m_roomCondition.wait(&m_roomMutex);
+				continue;
+			}
+			qint64 msLeft = msTimeout - timer.elapsed();
+			if (msLeft <= 0)
+			{
+				break;
+			}
+			m_roomCondition.wait(&m_roomMutex, (unsigned long)msLeft);
+		}
+	}
+	m_blockedProducers.fetchAndSubOrdered(1);
+	return pushed;
+}
+
+void QLambdaThreadStageBase::setOutput(QLambdaThreadStageOutputBase * p_output)
+{
+	delete mp_output;
+	mp_output = p_output;
+}
+
+void QLambdaThreadStageBase::drain()
+{
+	forever
+	{
+		DrainResult result = this->drainBatch(QLAMBDATHREADSTAGE_MAX_BATCH);
+		if (result == Yield)
+		{
+			// still scheduled, let other tasks of the thread run and continue later
+			QExplicitlySharedDataPointer<QLambdaThreadStageBase> p_self(this);
+			if (!m_executor.execInThread([p_self]() {
+				p_self->drain();
+			}))
+			{
+				m_scheduled.storeRelease(0);
+			}
+			return;
+		}
+		m_scheduled.fetchAndStoreOrdered(0);
+		// NOTE : a push or room made after the batch found nothing to do may have seen the drain still
+		//        scheduled, so check again now that it is not
+		if (!this->hasWork() || !m_scheduled.testAndSetOrdered(0, 1))
+		{
+			return;
+		}
+	}
+}
@@ -0,0 +1,144 @@
+#ifndef QLAMBDATHREADPIPELINEDATA_H
+#define QLAMBDATHREADPIPELINEDATA_H
+
+#include <QSharedData>
+#include <QExplicitlySharedDataPointer>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInteger>
+#include <QAtomicInt>
+#include <QList>
+#include <functional>
+
+#include "qlambdathreadring.hpp"
+#include "qlambdathreadworker.h"
+#include "qlambdathreadpool.h"
+
+// default number of items that can be queued in a stage
+#define QLAMBDATHREADSTAGE_CAPACITY  1024
+// max number of items processed by a stage before letting other tasks of its thread run
+#define QLAMBDATHREADSTAGE_MAX_BATCH 64
+
+// metrics of a pipeline stage
+struct QLambdaThreadStageMetrics
+{
+	// items processed by the stage function
+	quint64 processed;
+	// items for which the stage function threw (included in processed, no result sent downstream)
+	quint64 failed;
+	// pushes refused because the queue was full
+	quint64 rejected;
+	// times a producer or upstream stage had to wait for room
+	quint64 blocked;
+	// items currently queued
+	int     occupancy;
+	// maximum number of items ever queued at the same time
+	int     maxOccupancy;
+	int     capacity;
+	// cumulative time spent in the stage function in nanoseconds
+	qint64  busyNs;
+	// items processed per second since the first item was queued
+	double  throughput;
+};
+
+// QLAMBDATHREADSTAGEEXECUTOR -------------------------------------------------
+
+// where a stage runs, a single worker or any thread of a pool (one thread at a time)
+class QLambdaThreadStageExecutor
+{
+public:
+	QLambdaThreadStageExecutor(const QLambdaThreadWorker &worker);
+	QLambdaThreadStageExecutor(const QLambdaThreadPool &pool);
+
+	bool execInThread(const std::function<void()> &threadFunc) const;
+
+private:
+	std::function<bool(const std::function<void()> &)> m_execFunc;
+};
+
+// QLAMBDATHREADSTAGEOUTPUTBASE -----------------------------------------------
+
+// connection of a stage to its downstream, holds a result that did not fit downstream yet
+class QLambdaThreadStageOutputBase
+{
+public:
+	virtual ~QLambdaThreadStageOutputBase();
+
+	// push pending result (if any), false if downstream is still full
+	virtual bool flush() = 0;
+	// true if there is a pending result and downstream has room for it
+	virtual bool canFlush() const = 0;
+	virtual bool hasPending() const = 0;
+};
+
+// QLAMBDATHREADSTAGEBASE -----------------------------------------------------
+
+// scheduling, backpressure and metrics of a stage, independent of the item type
+class QLambdaThreadStageBase : public QSharedData
+{
+public:
+	QLambdaThreadStageBase(const QLambdaThreadStageExecutor &executor);
+	QLambdaThreadStageBase(const QLambdaThreadStageBase &other);
+	virtual ~QLambdaThreadStageBase();
+
+	QLambdaThreadStageMetrics getMetrics() const;
+
+	// make sure a drain is queued in the executor
+	void scheduleDrain();
+	// upstream stage could not push here, its drain gets scheduled when room is made
+	void addWaitingUpstream(QLambdaThreadStageBase * p_upstream);
+
+	// take ownership of output
+	void setOutput(QLambdaThreadStageOutputBase * p_output);
+
+	virtual int  occupancy() const = 0;
+	virtual int  capacity() const = 0;
+	virtual bool isFull() const = 0;
+
+protected:
+	enum DrainResult
+	{
+		Empty,
+		Blocked,
+		Yield
+	};
+	// process up to intMaxItems queued items (runs in executor's thread)
+	virtual DrainResult drainBatch(const int &intMaxItems) = 0;
+	// true if queued items (or a pending result with room downstream) can be processed
+	virtual bool hasWork() const = 0;
+
+	// call after each push, for the metrics
+	void afterPush();
+	// call after each pop, wakes blocked producers and resumes waiting upstream stages
+	void afterPop();
+	// block until tryPushFunc succeeds or msTimeout elapses (msTimeout < 0 waits forever)
+	bool waitForRoom(const std::function<bool()> &tryPushFunc, const int &msTimeout);
+
+	// nullptr for sink stages
+	QLambdaThreadStageOutputBase * mp_output;
+	QElapsedTimer                  m_clock;
+	QAtomicInteger<quint64>        m_processed;
+	QAtomicInteger<quint64>        m_failed;
+	QAtomicInteger<quint64>        m_rejected;
+	QAtomicInteger<quint64>        m_blocked;
+	QAtomicInteger<qint64>         m_busyNs;
+
+private:
+	// execute batches until empty or blocked (runs in executor's thread)
+	void drain();
+
+	QLambdaThreadStageExecutor                                  m_executor;
+	// 1 if a drain is queued or running
+	QAtomicInt                                                  m_scheduled;
+	QAtomicInt                                                  m_maxOccupancy;
+	QAtomicInteger<qint64>                                      m_firstPushNs;
+	// blocked producers and upstream stages, protected by m_roomMutex
+	QMutex                                                      m_roomMutex;
+	QWaitCondition                                              m_roomCondition;
+	QAtomicInt                                                  m_blockedProducers;
+	QList<QExplicitlySharedDataPointer<QLambdaThreadStageBase>> m_listWaitingUpstream;
+	QAtomicInt                                                  m_hasWaitingUpstream;
+};
+
+#endif // QLAMBDATHREADPIPELINEDATA_H
@@ -0,0 +1,76 @@
+#include "qlambdathreadpool.h"
+
+QLambdaThreadPool::QLambdaThreadPool(const int &intThreadCount/* = QThread::idealThreadCount()*/) : m_data(nullptr)
+{
+	m_data = QExplicitlySharedDataPointer<QLambdaThreadPoolData>(new QLambdaThreadPoolData(intThreadCount));
+}
+
+QLambdaThreadPool::QLambdaThreadPool(const int &intThreadCount, const QLambdaThreadWorkerOptions &options) : m_data(nullptr)
+{
+	m_data = QExplicitlySharedDataPointer<QLambdaThreadPoolData>(new QLambdaThreadPoolData(intThreadCount, options));
+}
+
+QLambdaThreadPool::QLambdaThreadPool(const QLambdaThreadPool &other) : m_data(other.m_data)
+{
+	m_data.reset();
+	m_data = other.m_data;
+}
+
+QLambdaThreadPool & QLambdaThreadPool::operator=(const QLambdaThreadPool &rhs)
+{
+	if (this != &rhs) {
+		m_data.reset();
+		m_data.operator=(rhs.m_data);
+	}
+	return *this;
+}
+
+QLambdaThreadPool::~QLambdaThreadPool()
+{
+	m_data.reset();
+}
+
+bool QLambdaThreadPool::execInThread(const std::function<void()> &threadFunc, const Qt::EventPriority &priority/* = Qt::NormalEventPriority*/, const int &intWorkerIndex/* = -1*/)
+{
+	return m_data->execInThread(threadFunc, priority, intWorkerIndex);
+}
+
+int QLambdaThreadPool::getThreadCount()
+{
+	return m_data->getThreadCount();
+}
+
+QLambdaThreadWorker QLambdaThreadPool::getWorker(const int &intWorkerIndex)
+{
+	return m_data->getWorker(intWorkerIndex);
+}
+
+int QLambdaThreadPool::getWorkerIndex(QThread * pThread/* = QThread::currentThread()*/)
+{
+	return m_data->getWorkerIndex(pThread);
+}
+
+int QLambdaThreadPool::startLoopInThread(const std::function<void()> &threadLoopFunc, const quint32 &uiMsSleep/* = 1000*/, const int &intWorkerIndex/* = -1*/)
+{
+	return m_data->startLoopInThread(threadLoopFunc, uiMsSleep, intWorkerIndex);
+}
+
+QDefer QLambdaThreadPool::stopLoopInThread(const int &intLoopId)
+{
+	return m_data->stopLoopInThread(intLoopId);
+}
+
+QDefer QLambdaThreadPool::stopAllLoopsInThread()
+{
+	return m_data->stopAllLoopsInThread();
+}
+
+bool QLambdaThreadPool::moveQObjectToThread(QObject * pObject, const int &intWorkerIndex)
+{
+	return m_data->moveQObjectToThread(pObject, intWorkerIndex);
+}
+
+QDefer QLambdaThreadPool::quitThread()
+{
+	return m_data->quitThread();
+}
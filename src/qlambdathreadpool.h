@@ -0,0 +1,47 @@
+#ifndef QLAMBDATHREADPOOL_H
+#define QLAMBDATHREADPOOL_H
+
+#include <QExplicitlySharedDataPointer>
+#include <QDeferred>
+#include "qlambdathreadpooldata.h"
+
+// pool of QLambdaThreadWorker with a work stealing scheduler
+// NOTE : * tasks without a worker index can run in any worker, each worker has its own queue and
+//          steals from the others when its own is empty, so bursts are spread across all threads
+//        * tasks, loops and objects that need a specific thread (e.g. QObject affinity) take a worker index
+class QLambdaThreadPool
+{
+public:
+	// constructors
+	QLambdaThreadPool(const int &intThreadCount = QThread::idealThreadCount());
+	// options are applied to every worker, the worker index is appended to the name
+	QLambdaThreadPool(const int &intThreadCount, const QLambdaThreadWorkerOptions &options);
+	QLambdaThreadPool(const QLambdaThreadPool &other);
+	QLambdaThreadPool &operator=(const QLambdaThreadPool &rhs);
+	~QLambdaThreadPool();
+
+	bool                execInThread(const std::function<void()> &threadFunc, const Qt::EventPriority &priority = Qt::NormalEventPriority, const int &intWorkerIndex = -1);
+
+	int                 getThreadCount();
+
+	QLambdaThreadWorker getWorker(const int &intWorkerIndex);
+
+	// index of the worker owning the thread, -1 if not a thread of the pool
+	int                 getWorkerIndex(QThread * pThread = QThread::currentThread());
+
+	int                 startLoopInThread(const std::function<void()> &threadLoopFunc, const quint32 &uiMsSleep = 1000, const int &intWorkerIndex = -1);
+
+	QDefer              stopLoopInThread(const int &intLoopId);
+
+	QDefer              stopAllLoopsInThread();
+
+	bool                moveQObjectToThread(QObject * pObject, const int &intWorkerIndex);
+
+	QDefer              quitThread();
+
+protected:
+	QExplicitlySharedDataPointer<QLambdaThreadPoolData> m_data;
+
+};
+
+#endif // QLAMBDATHREADPOOL_H
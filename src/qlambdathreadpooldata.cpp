@@ -0,0 +1,291 @@
+#include "qlambdathreadpooldata.h"
+
+// QLAMBDATHREADPOOLQUEUE -----------------------------------------------------
+
+QLambdaThreadPoolQueue::QLambdaThreadPoolQueue() :
+	m_scheduled(0)
+{
+	// nothing to do here
+}
+
+void QLambdaThreadPoolQueue::push(const std::function<void()> &threadFunc, const Qt::EventPriority &priority)
+{
+	QMutexLocker locker(&m_mutex);
+	if (priority > Qt::NormalEventPriority)
+	{
+		m_tasks.prepend(threadFunc);
+		return;
+	}
+	m_tasks.append(threadFunc);
+}
+
+bool QLambdaThreadPoolQueue::popFront(std::function<void()> &threadFunc)
+{
+	QMutexLocker locker(&m_mutex);
+	if (m_tasks.isEmpty())
+	{
+		return false;
+	}
+	threadFunc = m_tasks.takeFirst();
+	return true;
+}
+
+bool QLambdaThreadPoolQueue::popBack(std::function<void()> &threadFunc)
+{
+	QMutexLocker locker(&m_mutex);
+	if (m_tasks.isEmpty())
+	{
+		return false;
+	}
+	threadFunc = m_tasks.takeLast();
+	return true;
+}
+
+int QLambdaThreadPoolQueue::count()
+{
+	QMutexLocker locker(&m_mutex);
+	return m_tasks.count();
+}
+
+// QLAMBDATHREADPOOLDATA ------------------------------------------------------
+
+QLambdaThreadPoolData::QLambdaThreadPoolData(const int &intThreadCount, const QLambdaThreadWorkerOptions &options/* = QLambdaThreadWorkerOptions()*/) :
+	m_nextWorker(0),
+	m_intIdCounter(0),
+	m_requestedQuit(0)
+{
+	// NOTE : idealThreadCount() can return -1 if the number of cores cannot be detected
+	for (int i = 0; i < qMax(1, intThreadCount); i++)
+	{
+		QLambdaThreadWorkerOptions workerOptions = options;
+		if (!workerOptions.name.isEmpty())
+		{
+			workerOptions.name += QString::number(i);
+		}
+		m_workers.append(QLambdaThreadWorker(workerOptions));
+		m_queues.append(new QLambdaThreadPoolQueue);
+	}
+}
+
+QLambdaThreadPoolData::QLambdaThreadPoolData(const QLambdaThreadPoolData &other) :
+	QSharedData(other),
+	m_workers      (other.m_workers      ),
+	m_queues       (other.m_queues       ),
+	m_nextWorker   (0                    ),
+	m_mapLoopIds   (other.m_mapLoopIds   ),
+	m_intIdCounter (other.m_intIdCounter ),
+	m_requestedQuit(other.m_requestedQuit)
+{
+
+}
+
+QLambdaThreadPoolData::~QLambdaThreadPoolData()
+{
+	// NOTE : pending drains keep a reference to this object, so no worker is using the queues anymore
+	qDeleteAll(m_queues);
+	m_queues.clear();
+}
+
+bool QLambdaThreadPoolData::execInThread(const std::function<void()> &threadFunc, const Qt::EventPriority &priority/* = Qt::NormalEventPriority*/, const int &intWorkerIndex/* = -1*/)
+{
+	// tasks submitted from a worker stay in its queue (cache friendly), others are distributed round robin
+	int intTarget = intWorkerIndex < 0 ? this->getWorkerIndex(QThread::currentThread()) : -1;
+	// NOTE : while quitting, tasks submitted by running tasks of the pool are still accepted (e.g. continuations),
+	//        they go to the queue being drained by the current thread, which is emptied before its worker quits
+	if (m_requestedQuit.loadAcquire() && intTarget < 0)
+	{
+		return false;
+	}
+	// pinned task, goes directly to the worker's event loop
+	if (intWorkerIndex >= 0)
+	{
+		Q_ASSERT_X(intWorkerIndex < m_workers.count(), "QLambdaThreadPool::execInThread", "Invalid worker index.");
+		return m_workers[intWorkerIndex].execInThread(threadFunc, priority);
+	}
+	if (intTarget < 0)
+	{
+		intTarget = (m_nextWorker.fetchAndAddRelaxed(1) & 0x7fffffff) % m_workers.count();
+	}
+	m_queues[intTarget]->push(threadFunc, priority);
+	this->scheduleDrain(intTarget);
+	// work is piling up, wake an idle worker so it can steal
+	if (m_queues[intTarget]->count() > 1)
+	{
+		for (int i = 0; i < m_workers.count(); i++)
+		{
+			if (i != intTarget && m_queues[i]->m_scheduled.loadAcquire() == 0)
+			{
+				this->scheduleDrain(i);
+				break;
+			}
+		}
+	}
+	// success
+	return true;
+}
+
+int QLambdaThreadPoolData::getThreadCount()
+{
+	return m_workers.count();
+}
+
+QLambdaThreadWorker QLambdaThreadPoolData::getWorker(const int &intWorkerIndex)
+{
+	Q_ASSERT_X(intWorkerIndex >= 0 && intWorkerIndex < m_workers.count(), "QLambdaThreadPool::getWorker", "Invalid worker index.");
+	return m_workers[intWorkerIndex];
+}
+
+int QLambdaThreadPoolData::getWorkerIndex(QThread * pThread)
+{
+	for (int i = 0; i < m_workers.count(); i++)
+	{
+		if (m_workers[i].getThread() == pThread)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+int QLambdaThreadPoolData::startLoopInThread(const std::function<void()> &threadLoopFunc, const quint32 &uiMsSleep/* = 1000*/, const int &intWorkerIndex/* = -1*/)
+{
+	if (m_requestedQuit.loadAcquire())
+	{
+		return -1;
+	}
+	// loops are timers, so they are always pinned to a worker
+	int intTarget = intWorkerIndex;
+	if (intTarget < 0)
+	{
+		intTarget = (m_nextWorker.fetchAndAddRelaxed(1) & 0x7fffffff) % m_workers.count();
+	}
+	Q_ASSERT_X(intTarget < m_workers.count(), "QLambdaThreadPool::startLoopInThread", "Invalid worker index.");
+	int intWorkerLoopId = m_workers[intTarget].startLoopInThread(threadLoopFunc, uiMsSleep);
+	if (intWorkerLoopId < 0)
+	{
+		return -1;
+	}
+	// worker loop ids are only unique per worker
+	QMutexLocker locker(&m_mutex);
+	m_intIdCounter++;
+	m_mapLoopIds[m_intIdCounter] = qMakePair(intTarget, intWorkerLoopId);
+	return m_intIdCounter;
+}
+
+QDefer QLambdaThreadPoolData::stopLoopInThread(const int &intLoopId)
+{
+	QMutexLocker locker(&m_mutex);
+	if (!m_mapLoopIds.contains(intLoopId))
+	{
+		qWarning() << "QLambdaThreadPool::stopLoopInThread : Invalid loop Id.";
+		QDefer retDefer;
+		retDefer.reject();
+		return retDefer;
+	}
+	auto workerLoop = m_mapLoopIds.take(intLoopId);
+	return m_workers[workerLoop.first].stopLoopInThread(workerLoop.second);
+}
+
+QDefer QLambdaThreadPoolData::stopAllLoopsInThread()
+{
+	QMutexLocker locker(&m_mutex);
+	m_mapLoopIds.clear();
+	QList<QDefer> listDefers;
+	for (int i = 0; i < m_workers.count(); i++)
+	{
+		listDefers.append(m_workers[i].stopAllLoopsInThread());
+	}
+	return QDefer::when(listDefers);
+}
+
+bool QLambdaThreadPoolData::moveQObjectToThread(QObject * pObject, const int &intWorkerIndex)
+{
+	if (m_requestedQuit.loadAcquire())
+	{
+		return false;
+	}
+	Q_ASSERT_X(intWorkerIndex >= 0 && intWorkerIndex < m_workers.count(), "QLambdaThreadPool::moveQObjectToThread", "Invalid worker index.");
+	return m_workers[intWorkerIndex].moveQObjectToThread(pObject);
+}
+
+QDefer QLambdaThreadPoolData::quitThread()
+{
+	// stop accepting new callbacks or loops
+	m_requestedQuit.storeRelease(1);
+	// NOTE : a final drain is queued in every worker before it quits, since a drain that reached the batch limit
+	//        just before the quit was requested could not reschedule itself (worker rejects new callbacks once quitting).
+	//        Each worker processes its pending callbacks (including the final drain) before quitting
+	QExplicitlySharedDataPointer<QLambdaThreadPoolData> p_self(this);
+	for (int i = 0; i < m_workers.count(); i++)
+	{
+		int intIndex = i;
+		m_workers[i].execInThread([p_self, intIndex]() {
+			p_self->drain(intIndex);
+		});
+	}
+	QList<QDefer> listDefers;
+	for (int i = 0; i < m_workers.count(); i++)
+	{
+		listDefers.append(m_workers[i].quitThread());
+	}
+	return QDefer::when(listDefers);
+}
+
+void QLambdaThreadPoolData::scheduleDrain(const int &intWorkerIndex)
+{
+	if (!m_queues[intWorkerIndex]->m_scheduled.testAndSetOrdered(0, 1))
+	{
+		return;
+	}
+	// keep this object alive until the drain is executed
+	QExplicitlySharedDataPointer<QLambdaThreadPoolData> p_self(this);
+	int intIndex = intWorkerIndex;
+	bool ok = m_workers[intWorkerIndex].execInThread([p_self, intIndex]() {
+		p_self->drain(intIndex);
+	});
+	// worker is quitting
+	if (!ok)
+	{
+		m_queues[intWorkerIndex]->m_scheduled.storeRelease(0);
+	}
+}
+
+void QLambdaThreadPoolData::drain(const int &intWorkerIndex)
+{
+	auto p_queue = m_queues[intWorkerIndex];
+	int  count   = 0;
+	std::function<void()> threadFunc;
+	while (count < QLAMBDATHREADPOOL_MAX_BATCH || m_requestedQuit.loadAcquire())
+	{
+		if (!p_queue->popFront(threadFunc) && !this->steal(intWorkerIndex, threadFunc))
+		{
+			p_queue->m_scheduled.storeRelease(0);
+			// NOTE : a task might have been pushed after the queue was found empty, but before the flag was reset
+			if (p_queue->count() > 0)
+			{
+				this->scheduleDrain(intWorkerIndex);
+			}
+			return;
+		}
+		threadFunc();
+		threadFunc = nullptr;
+		count++;
+	}
+	// let the event loop run, then continue
+	p_queue->m_scheduled.storeRelease(0);
+	this->scheduleDrain(intWorkerIndex);
+}
+
+bool QLambdaThreadPoolData::steal(const int &intWorkerIndex, std::function<void()> &threadFunc)
+{
+	// start from the next worker, so thieves do not all hit the same victim
+	for (int i = 1; i < m_queues.count(); i++)
+	{
+		int intVictim = (intWorkerIndex + i) % m_queues.count();
+		if (m_queues[intVictim]->popBack(threadFunc))
+		{
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,89 @@
+#ifndef QLAMBDATHREADPOOLDATA_H
+#define QLAMBDATHREADPOOLDATA_H
+
+#include <QSharedData>
+#include <QThread>
+#include <QMutex>
+#include <QList>
+#include <QMap>
+#include <QAtomicInt>
+#include <QDeferred>
+#include <functional>
+
+#include "qlambdathreadworker.h"
+
+// max number of tasks executed by a worker before letting its event loop run (timers, pinned tasks, etc.)
+#define QLAMBDATHREADPOOL_MAX_BATCH 64
+
+// QLAMBDATHREADPOOLQUEUE -----------------------------------------------------
+
+// double ended queue of tasks of a worker, owner takes from the front, thieves from the back
+class QLambdaThreadPoolQueue
+{
+public:
+	QLambdaThreadPoolQueue();
+
+	// add task, high priority tasks are added to the front
+	void push(const std::function<void()> &threadFunc, const Qt::EventPriority &priority);
+	// take oldest task (owner)
+	bool popFront(std::function<void()> &threadFunc);
+	// take newest task (thief)
+	bool popBack(std::function<void()> &threadFunc);
+	// number of queued tasks
+	int  count();
+
+	// 1 if a drain of this queue is pending in the worker's event loop
+	QAtomicInt m_scheduled;
+
+private:
+	QMutex                       m_mutex;
+	QList<std::function<void()>> m_tasks;
+};
+
+// QLAMBDATHREADPOOLDATA ------------------------------------------------------
+
+class QLambdaThreadPoolData : public QSharedData
+{
+public:
+	QLambdaThreadPoolData(const int &intThreadCount, const QLambdaThreadWorkerOptions &options = QLambdaThreadWorkerOptions());
+	QLambdaThreadPoolData(const QLambdaThreadPoolData &other);
+	~QLambdaThreadPoolData();
+
+	bool                execInThread(const std::function<void()> &threadFunc, const Qt::EventPriority &priority = Qt::NormalEventPriority, const int &intWorkerIndex = -1);
+
+	int                 getThreadCount();
+
+	QLambdaThreadWorker getWorker(const int &intWorkerIndex);
+
+	int                 getWorkerIndex(QThread * pThread);
+
+	int                 startLoopInThread(const std::function<void()> &threadLoopFunc, const quint32 &uiMsSleep = 1000, const int &intWorkerIndex = -1);
+
+	QDefer              stopLoopInThread(const int &intLoopId);
+
+	QDefer              stopAllLoopsInThread();
+
+	bool                moveQObjectToThread(QObject * pObject, const int &intWorkerIndex);
+
+	QDefer              quitThread();
+
+private:
+	QList<QLambdaThreadWorker>      m_workers;
+	QList<QLambdaThreadPoolQueue *> m_queues;
+	// next worker for tasks submitted from outside the pool
+	QAtomicInt                      m_nextWorker;
+	// map of pool loop id, to worker index and worker loop id
+	QMutex                          m_mutex;
+	QMap<int, QPair<int, int>>      m_mapLoopIds;
+	int                             m_intIdCounter;
+	QAtomicInt                      m_requestedQuit;
+	// make sure a drain of the worker's queue is pending
+	void scheduleDrain(const int &intWorkerIndex);
+	// execute tasks of own queue, steal from the others when empty (runs in worker's thread)
+	// NOTE : once quit is requested there is no batch limit, so all queues are emptied before the workers quit
+	void drain(const int &intWorkerIndex);
+	// take task from the back of another worker's queue
+	bool steal(const int &intWorkerIndex, std::function<void()> &threadFunc);
+};
+
+#endif // QLAMBDATHREADPOOLDATA_H
@@ -0,0 +1,189 @@
+#ifndef QLAMBDATHREADRING_H
+#define QLAMBDATHREADRING_H
+
+#include <QtGlobal>
+#include <QAtomicInteger>
+#include <utility>
+
+// bounded lock-free multiple producer multiple consumer ring of values
+// NOTE : * based on Dmitry Vyukov's bounded MPMC queue, each cell has a sequence number telling
+//          producers and consumers whose turn it is, so neither needs a lock
+//        * T must be default constructible and movable, popped cells are reset to T() so they
+//          do not keep resources alive
+template<typename T>
+class QLambdaThreadRing
+{
+public:
+	// capacity is rounded up to a power of two
+	explicit QLambdaThreadRing(const int &intCapacity);
+	~QLambdaThreadRing();
+
+	// false if full
+	bool push(const T &item);
+	bool push(T &&item);
+	// false if empty or if a producer is in the middle of a push
+	bool pop(T &item);
+
+	// approximate when other threads are pushing or popping
+	int  count() const;
+	bool isEmpty() const;
+	bool isFull() const;
+	int  capacity() const;
+
+private:
+	Q_DISABLE_COPY(QLambdaThreadRing)
+	struct Cell
+	{
+		QAtomicInteger<quint64> m_sequence;
+		T                       m_item;
+	};
+	// claim cell to write, nullptr if full
+	Cell * claimPush(quint64 &pos);
+	Cell                  * mp_cells;
+	quint64                 m_mask;
+	QAtomicInteger<quint64> m_enqueuePos;
+	QAtomicInteger<quint64> m_dequeuePos;
+};
+
+template<typename T>
+QLambdaThreadRing<T>::QLambdaThreadRing(const int &intCapacity) :
+	m_enqueuePos(0),
+	m_dequeuePos(0)
+{
+	quint64 capacity = 2;
+	while (capacity < (quint64)qMax(2, intCapacity))
+	{
+		capacity *= 2;
+	}
+	m_mask   = capacity - 1;
+	mp_cells = new Cell[capacity];
+	for (quint64 i = 0; i < capacity; i++)
+	{
+		mp_cells[i].m_sequence.storeRelease(i);
+	}
+}
+
+template<typename T>
+QLambdaThreadRing<T>::~QLambdaThreadRing()
+{
+	delete[] mp_cells;
+}
+
+template<typename T>
+typename QLambdaThreadRing<T>::Cell * QLambdaThreadRing<T>::claimPush(quint64 &pos)
+{
+	pos = m_enqueuePos.loadAcquire();
+	forever
+	{
+		Cell * p_cell = &mp_cells[pos & m_mask];
+		qint64 diff   = (qint64)p_cell->m_sequence.loadAcquire() - (qint64)pos;
+		if (diff == 0)
+		{
+			// cell free, claim it
+			if (m_enqueuePos.testAndSetRelaxed(pos, pos + 1, pos))
+			{
+				return p_cell;
+			}
+		}
+		else if (diff < 0)
+		{
+			// cell still used by the previous lap, full
+			return nullptr;
+		}
+		else
+		{
+			// another producer claimed it
+			pos = m_enqueuePos.loadAcquire();
+		}
+	}
+}
+
+template<typename T>
+bool QLambdaThreadRing<T>::push(const T &item)
+{
+	quint64 pos    = 0;
+	Cell  * p_cell = this->claimPush(pos);
+	if (!p_cell)
+	{
+		return false;
+	}
+	p_cell->m_item = item;
+	p_cell->m_sequence.storeRelease(pos + 1);
+	return true;
+}
+
+template<typename T>
+bool QLambdaThreadRing<T>::push(T &&item)
+{
+	quint64 pos    = 0;
+	Cell  * p_cell = this->claimPush(pos);
+	if (!p_cell)
+	{
+		return false;
+	}
+	p_cell->m_item = std::move(item);
+	p_cell->m_sequence.storeRelease(pos + 1);
+	return true;
+}
+
+template<typename T>
+bool QLambdaThreadRing<T>::pop(T &item)
+{
+	Cell  * p_cell = nullptr;
+	quint64 pos    = m_dequeuePos.loadAcquire();
+	forever
+	{
+		p_cell = &mp_cells[pos & m_mask];
+		qint64 diff = (qint64)p_cell->m_sequence.loadAcquire() - (qint64)(pos + 1);
+		if (diff == 0)
+		{
+			// cell written, claim it
+			if (m_dequeuePos.testAndSetRelaxed(pos, pos + 1, pos))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			// not written yet, empty
+			return false;
+		}
+		else
+		{
+			// another consumer claimed it
+			pos = m_dequeuePos.loadAcquire();
+		}
+	}
+	item           = std::move(p_cell->m_item);
+	p_cell->m_item = T();
+	// free cell for the next lap
+	p_cell->m_sequence.storeRelease(pos + m_mask + 1);
+	return true;
+}
+
+template<typename T>
+int QLambdaThreadRing<T>::count() const
+{
+	qint64 diff = (qint64)(m_enqueuePos.loadAcquire() - m_dequeuePos.loadAcquire());
+	return (int)qBound((qint64)0, diff, (qint64)m_mask + 1);
+}
+
+template<typename T>
+bool QLambdaThreadRing<T>::isEmpty() const
+{
+	return this->count() == 0;
+}
+
+template<typename T>
+bool QLambdaThreadRing<T>::isFull() const
+{
+	return this->count() > (int)m_mask;
+}
+
+template<typename T>
+int QLambdaThreadRing<T>::capacity() const
+{
+	return (int)m_mask + 1;
+}
+
+#endif // QLAMBDATHREADRING_H
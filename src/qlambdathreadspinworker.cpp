@@ -0,0 +1,47 @@
+#include "qlambdathreadspinworker.h"
+
+QLambdaThreadSpinWorker::QLambdaThreadSpinWorker(const QLambdaThreadWorkerOptions &options/* = QLambdaThreadWorkerOptions()*/, const int &intCapacity/* = QLAMBDATHREADSPINWORKER_CAPACITY*/) : m_data(nullptr)
+{
+	m_data = QExplicitlySharedDataPointer<QLambdaThreadSpinWorkerData>(new QLambdaThreadSpinWorkerData(options, intCapacity));
+}
+
+QLambdaThreadSpinWorker::QLambdaThreadSpinWorker(const QLambdaThreadSpinWorker &other) : m_data(other.m_data)
+{
+	m_data.reset();
+	m_data = other.m_data;
+}
+
+QLambdaThreadSpinWorker & QLambdaThreadSpinWorker::operator=(const QLambdaThreadSpinWorker &rhs)
+{
+	if (this != &rhs) {
+		m_data.reset();
+		m_data.operator=(rhs.m_data);
+	}
+	return *this;
+}
+
+QLambdaThreadSpinWorker::~QLambdaThreadSpinWorker()
+{
+	m_data.reset();
+}
+
+bool QLambdaThreadSpinWorker::execInThread(const std::function<void()> &threadFunc, const Qt::EventPriority &priority/* = Qt::NormalEventPriority*/)
+{
+	Q_UNUSED(priority);
+	return m_data->execInThread(threadFunc);
+}
+
+QString QLambdaThreadSpinWorker::getThreadId()
+{
+	return m_data->getThreadId();
+}
+
+QThread * QLambdaThreadSpinWorker::getThread()
+{
+	return m_data->getThread();
+}
+
+QDefer QLambdaThreadSpinWorker::quitThread()
+{
+	return m_data->quitThread();
+}
@@ -0,0 +1,58 @@
+#ifndef QLAMBDATHREADSPINWORKER_H
+#define QLAMBDATHREADSPINWORKER_H
+
+#include <QExplicitlySharedDataPointer>
+#include <QDeferred>
+#include "qlambdathreadworker.h"
+#include "qlambdathreadspinworkerdata.h"
+
+// worker whose thread polls a lock-free ring of tasks instead of running a Qt event loop
+// NOTE : * a task posted to a spinning thread is picked up without any system call, when idle for a while
+//          the thread parks (futex on linux) and the next task wakes it up
+//        * meant for latency critical paths, a spinning thread keeps its cpu busy
+//        * Qt events posted to the thread (e.g. callbacks of deferreds registered in it) are delivered
+//          between tasks when the ring is empty, and at least every QLAMBDATHREADSPINWORKER_PARK_MS while parked
+//        * no loops and no QObjects can be moved to the thread, use QLambdaThreadWorker for that
+class QLambdaThreadSpinWorker
+{
+public:
+	// constructors
+	QLambdaThreadSpinWorker(const QLambdaThreadWorkerOptions &options = QLambdaThreadWorkerOptions(), const int &intCapacity = QLAMBDATHREADSPINWORKER_CAPACITY);
+	QLambdaThreadSpinWorker(const QLambdaThreadSpinWorker &other);
+	QLambdaThreadSpinWorker &operator=(const QLambdaThreadSpinWorker &rhs);
+	~QLambdaThreadSpinWorker();
+
+	// tasks are executed in posting order, priority is only accepted for compatibility with QLambdaThreadWorker
+	bool      execInThread(const std::function<void()> &threadFunc, const Qt::EventPriority &priority = Qt::NormalEventPriority);
+
+	// exec function in thread, returned deferred gets resolved with its return value or rejected if it throws
+	template<typename F>
+	typename QLambdaThreadWorkerRun<typename std::decay<typename std::result_of<F()>::type>::type>::Deferred run(F &&threadFunc);
+
+	QString   getThreadId();
+
+	QThread * getThread();
+
+	// execute queued tasks and quit
+	QDefer    quitThread();
+
+protected:
+	QExplicitlySharedDataPointer<QLambdaThreadSpinWorkerData> m_data;
+
+};
+
+template<typename F>
+typename QLambdaThreadWorkerRun<typename std::decay<typename std::result_of<F()>::type>::type>::Deferred QLambdaThreadSpinWorker::run(F &&threadFunc)
+{
+	typedef typename std::decay<typename std::result_of<F()>::type>::type R;
+	auto p_task    = new QLambdaThreadWorkerRunTask<typename std::decay<F>::type, R>(std::forward<F>(threadFunc));
+	auto retDefer  = p_task->m_defer;
+	// thread not running, task never executed (rejected when deleted)
+	if (!m_data->execNodeInThread(p_task))
+	{
+		delete p_task;
+	}
+	return retDefer;
+}
+
+#endif // QLAMBDATHREADSPINWORKER_H
@@ -0,0 +1,292 @@
+#include "qlambdathreadspinworkerdata.h"
+#include <QCoreApplication>
+#include <sstream>
+#ifdef Q_OS_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+#endif
+
+// QLAMBDATHREADSPINWORKERRING ----------------------------------------------
+
+QLambdaThreadSpinWorkerRing::QLambdaThreadSpinWorkerRing(const int &intCapacity) :
+	m_enqueuePos(0),
+	m_dequeuePos(0)
+{
+	quint64 capacity = 2;
+	while (capacity < (quint64)qMax(2, intCapacity))
+	{
+		capacity *= 2;
+	}
+	m_mask   = capacity - 1;
+	mp_cells = new Cell[capacity];
+	for (quint64 i = 0; i < capacity; i++)
+	{
+		mp_cells[i].m_sequence.storeRelease(i);
+		mp_cells[i].mp_node = nullptr;
+	}
+}
+
+QLambdaThreadSpinWorkerRing::~QLambdaThreadSpinWorkerRing()
+{
+	// delete tasks never executed
+	QEventMailboxNode * p_node = this->pop();
+	while (p_node)
+	{
+		delete p_node;
+		p_node = this->pop();
+	}
+	delete[] mp_cells;
+}
+
+bool QLambdaThreadSpinWorkerRing::push(QEventMailboxNode * p_node)
+{
+	Cell  * p_cell = nullptr;
+	quint64 pos    = m_enqueuePos.loadAcquire();
+	forever
+	{
+		p_cell = &mp_cells[pos & m_mask];
+		qint64 diff = (qint64)p_cell->m_sequence.loadAcquire() - (qint64)pos;
+		if (diff == 0)
+		{
+			// cell free, claim it
+			if (m_enqueuePos.testAndSetRelaxed(pos, pos + 1, pos))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			// cell still used by the previous lap, full
+			return false;
+		}
+		else
+		{
+			// another producer claimed it
+			pos = m_enqueuePos.loadAcquire();
+		}
+	}
+	p_cell->mp_node = p_node;
+	p_cell->m_sequence.storeRelease(pos + 1);
+	return true;
+}
+
+QEventMailboxNode * QLambdaThreadSpinWorkerRing::pop()
+{
+	Cell * p_cell = &mp_cells[m_dequeuePos & m_mask];
+	if (p_cell->m_sequence.loadAcquire() != m_dequeuePos + 1)
+	{
+		return nullptr;
+	}
+	QEventMailboxNode * p_node = p_cell->mp_node;
+	p_cell->mp_node = nullptr;
+	// free cell for the next lap
+	p_cell->m_sequence.storeRelease(m_dequeuePos + m_mask + 1);
+	m_dequeuePos++;
+	return p_node;
+}
+
+bool QLambdaThreadSpinWorkerRing::isEmpty() const
+{
+	return mp_cells[m_dequeuePos & m_mask].m_sequence.loadAcquire() != m_dequeuePos + 1;
+}
+
+// QLAMBDATHREADSPINWORKERTHREAD --------------------------------------------
+
+QLambdaThreadSpinWorkerThread::QLambdaThreadSpinWorkerThread(const QLambdaThreadWorkerOptions &options, const int &intCapacity) :
+	QThread(nullptr),
+	m_options(options),
+	m_ring(intCapacity),
+	m_quit(0),
+	m_parked(0)
+{
+	if (!options.name.isEmpty())
+	{
+		this->setObjectName(options.name);
+	}
+}
+
+bool QLambdaThreadSpinWorkerThread::postNode(QEventMailboxNode * p_node)
+{
+	while (!m_ring.push(p_node))
+	{
+		if (m_quit.loadAcquire())
+		{
+			return false;
+		}
+		// full, let the thread catch up
+		this->wake();
+		QThread::yieldCurrentThread();
+	}
+	this->wake();
+	return true;
+}
+
+void QLambdaThreadSpinWorkerThread::requestQuit()
+{
+	m_quit.storeRelease(1);
+	this->wake();
+}
+
+void QLambdaThreadSpinWorkerThread::run()
+{
+	QLambdaThreadWorkerData::applyThreadOptions(m_options);
+	int spinLimit = QLAMBDATHREADSPINWORKER_MIN_SPIN;
+	forever
+	{
+		QEventMailboxNode * p_node = m_ring.pop();
+		if (p_node)
+		{
+			p_node->exec();
+			delete p_node;
+			continue;
+		}
+		// nothing queued, deliver Qt events of this thread (e.g. deferred callbacks registered in it)
+		QCoreApplication::sendPostedEvents();
+		if (m_quit.loadAcquire() && m_ring.isEmpty())
+		{
+			break;
+		}
+		// spin a while before parking, longer if tasks tend to arrive while spinning
+		bool isFound = false;
+		for (int i = 0; i < spinLimit && !isFound; i++)
+		{
+#if defined(__x86_64__) || defined(__i386__)
+			__builtin_ia32_pause();
+#endif
+			isFound = !m_ring.isEmpty();
+		}
+		if (isFound)
+		{
+			spinLimit = qMin(spinLimit * 2, QLAMBDATHREADSPINWORKER_MAX_SPIN);
+			continue;
+		}
+		spinLimit = qMax(spinLimit / 2, QLAMBDATHREADSPINWORKER_MIN_SPIN);
+		this->park();
+	}
+	QCoreApplication::sendPostedEvents();
+}
+
+void QLambdaThreadSpinWorkerThread::park()
+{
+	// NOTE : announce before checking the ring, producers push before checking m_parked (both
+	//        sequentially consistent), so either we see the task or the producer sees us parked
+	m_parked.exchange(1);
+	if (!m_ring.isEmpty() || m_quit.loadAcquire())
+	{
+		m_parked.store(0);
+		return;
+	}
+#ifdef Q_OS_LINUX
+	struct timespec timeout;
+	timeout.tv_sec  = 0;
+	timeout.tv_nsec = QLAMBDATHREADSPINWORKER_PARK_MS * 1000000L;
+	syscall(SYS_futex, reinterpret_cast<int*>(&m_parked), FUTEX_WAIT_PRIVATE, 1, &timeout, nullptr, 0);
+#else
+	QThread::msleep(1);
+#endif
+	m_parked.store(0);
+}
+
+void QLambdaThreadSpinWorkerThread::wake()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_parked.load(std::memory_order_relaxed) == 0 || m_parked.exchange(0) == 0)
+	{
+		return;
+	}
+#ifdef Q_OS_LINUX
+	syscall(SYS_futex, reinterpret_cast<int*>(&m_parked), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+}
+
+// QLAMBDATHREADSPINWORKERDATA ----------------------------------------------
+
+QLambdaThreadSpinWorkerData::QLambdaThreadSpinWorkerData(const QLambdaThreadWorkerOptions &options, const int &intCapacity) :
+	m_requestedQuit(0)
+{
+	mp_workerThread = new QLambdaThreadSpinWorkerThread(options, intCapacity);
+	// get thread id
+	std::stringstream stream;
+	stream << std::hex << (size_t)mp_workerThread;
+	m_strThreadId = "QThread(0x" + QString::fromStdString(stream.str()) + ")";
+	if (!options.name.isEmpty())
+	{
+		m_strThreadId = options.name + " " + m_strThreadId;
+	}
+	QObject::connect(mp_workerThread, SIGNAL(finished()), mp_workerThread, SLOT(deleteLater()));
+	// start thread
+	if (options.stackSize > 0)
+	{
+		mp_workerThread->setStackSize(options.stackSize);
+	}
+	mp_workerThread->start(options.priority);
+}
+
+QLambdaThreadSpinWorkerData::QLambdaThreadSpinWorkerData(const QLambdaThreadSpinWorkerData &other) :
+	QSharedData(other),
+	mp_workerThread(other.mp_workerThread),
+	m_strThreadId  (other.m_strThreadId  ),
+	m_requestedQuit(other.m_requestedQuit.loadAcquire())
+{
+
+}
+
+QLambdaThreadSpinWorkerData::~QLambdaThreadSpinWorkerData()
+{
+	if (m_requestedQuit.loadAcquire())
+	{
+		return;
+	}
+	mp_workerThread->requestQuit();
+}
+
+bool QLambdaThreadSpinWorkerData::execInThread(const std::function<void()> &threadFunc)
+{
+	QEventMailboxNode * p_node = new QEventMailboxTask<std::function<void()>>(threadFunc);
+	if (!this->execNodeInThread(p_node))
+	{
+		delete p_node;
+		return false;
+	}
+	return true;
+}
+
+bool QLambdaThreadSpinWorkerData::execNodeInThread(QEventMailboxNode * p_node)
+{
+	if (m_requestedQuit.loadAcquire())
+	{
+		return false;
+	}
+	return mp_workerThread->postNode(p_node);
+}
+
+QString QLambdaThreadSpinWorkerData::getThreadId()
+{
+	return m_strThreadId;
+}
+
+QThread * QLambdaThreadSpinWorkerData::getThread()
+{
+	return mp_workerThread;
+}
+
+QDefer QLambdaThreadSpinWorkerData::quitThread()
+{
+	QDefer retDefer;
+	// stop accepting new tasks, only the first call quits
+	if (!m_requestedQuit.testAndSetOrdered(0, 1))
+	{
+		retDefer.resolve();
+		return retDefer;
+	}
+	// subscribe to thread finished, emitted from the thread itself
+	QObject::connect(mp_workerThread, &QThread::finished, [retDefer]() mutable {
+		retDefer.resolve();
+	});
+	// remaining tasks are executed before the thread finishes
+	mp_workerThread->requestQuit();
+	// return promise
+	return retDefer;
+}
@@ -0,0 +1,113 @@
+#ifndef QLAMBDATHREADSPINWORKERDATA_H
+#define QLAMBDATHREADSPINWORKERDATA_H
+
+#include <QThread>
+#include <QSharedData>
+#include <QAtomicInteger>
+#include <QDeferred>
+#include <atomic>
+#include <functional>
+
+#include "qeventmailbox.hpp"
+#include "qlambdathreadworkerdata.h"
+
+// default number of tasks that can be queued at the same time
+#define QLAMBDATHREADSPINWORKER_CAPACITY 4096
+// iterations spent polling an empty ring before parking, adapted between these limits
+#define QLAMBDATHREADSPINWORKER_MIN_SPIN 64
+#define QLAMBDATHREADSPINWORKER_MAX_SPIN 65536
+// maximum time parked, Qt events posted to the thread are only delivered when not parked
+#define QLAMBDATHREADSPINWORKER_PARK_MS  10
+
+// QLAMBDATHREADSPINWORKERRING ----------------------------------------------
+
+// bounded lock-free multiple producer single consumer ring of tasks
+// NOTE : based on Dmitry Vyukov's bounded MPMC queue, each cell has a sequence number telling
+//        producers and the consumer whose turn it is, so neither needs a lock
+class QLambdaThreadSpinWorkerRing
+{
+public:
+	// capacity is rounded up to a power of two
+	explicit QLambdaThreadSpinWorkerRing(const int &intCapacity);
+	~QLambdaThreadSpinWorkerRing();
+
+	// producer API (any thread), false if full
+	bool push(QEventMailboxNode * p_node);
+
+	// consumer API (ring thread)
+
+	// nullptr if empty or if a producer is in the middle of a push
+	QEventMailboxNode * pop();
+	bool isEmpty() const;
+
+private:
+	Q_DISABLE_COPY(QLambdaThreadSpinWorkerRing)
+	struct Cell
+	{
+		QAtomicInteger<quint64> m_sequence;
+		QEventMailboxNode     * mp_node;
+	};
+	Cell                  * mp_cells;
+	quint64                 m_mask;
+	QAtomicInteger<quint64> m_enqueuePos;
+	// only touched by the consumer
+	quint64                 m_dequeuePos;
+};
+
+// QLAMBDATHREADSPINWORKERTHREAD --------------------------------------------
+
+// thread polling the ring instead of running a Qt event loop, parks when idle
+class QLambdaThreadSpinWorkerThread : public QThread
+{
+public:
+	QLambdaThreadSpinWorkerThread(const QLambdaThreadWorkerOptions &options, const int &intCapacity);
+
+	// queue task (takes ownership), false if quitting
+	// NOTE : waits for the thread to make room if the ring is full
+	bool postNode(QEventMailboxNode * p_node);
+
+	// execute remaining tasks and finish
+	void requestQuit();
+
+protected:
+	void run();
+
+private:
+	void park();
+	void wake();
+
+	QLambdaThreadWorkerOptions  m_options;
+	QLambdaThreadSpinWorkerRing m_ring;
+	QAtomicInt                  m_quit;
+	// 1 while parked, std::atomic so its address can be used as futex word
+	std::atomic<int>            m_parked;
+};
+
+// QLAMBDATHREADSPINWORKERDATA ----------------------------------------------
+
+class QLambdaThreadSpinWorkerData : public QSharedData
+{
+public:
+	QLambdaThreadSpinWorkerData(const QLambdaThreadWorkerOptions &options, const int &intCapacity);
+	QLambdaThreadSpinWorkerData(const QLambdaThreadSpinWorkerData &other);
+	~QLambdaThreadSpinWorkerData();
+
+	bool     execInThread(const std::function<void()> &threadFunc);
+
+	// queue node to be executed in thread, false if thread not running (caller keeps ownership then)
+	bool     execNodeInThread(QEventMailboxNode * p_node);
+
+	QString  getThreadId();
+
+	QThread* getThread();
+
+	QDefer   quitThread();
+
+private:
+	QLambdaThreadSpinWorkerThread * mp_workerThread;
+	QString                         m_strThreadId;
+	// NOTE : atomic, any thread holding a copy of the worker can post or quit
+	QAtomicInt                      m_requestedQuit;
+};
+
+#endif // QLAMBDATHREADSPINWORKERDATA_H
@@ -0,0 +1,46 @@
+#include "qlambdathreadstrand.h"
+
+QLambdaThreadStrand::QLambdaThreadStrand(const QLambdaThreadPool &pool) : m_data(nullptr)
+{
+	m_data = QExplicitlySharedDataPointer<QLambdaThreadStrandData>(new QLambdaThreadStrandData(pool));
+}
+
+QLambdaThreadStrand::QLambdaThreadStrand(const QLambdaThreadStrand &other) : m_data(other.m_data)
+{
+	m_data.reset();
+	m_data = other.m_data;
+}
+
+QLambdaThreadStrand & QLambdaThreadStrand::operator=(const QLambdaThreadStrand &rhs)
+{
+	if (this != &rhs) {
+		m_data.reset();
+		m_data.operator=(rhs.m_data);
+	}
+	return *this;
+}
+
+QLambdaThreadStrand::~QLambdaThreadStrand()
+{
+	m_data.reset();
+}
+
+bool QLambdaThreadStrand::execInThread(const std::function<void()> &threadFunc)
+{
+	return m_data->execInThread(threadFunc);
+}
+
+int QLambdaThreadStrand::getPendingCount()
+{
+	return m_data->getPendingCount();
+}
+
+bool QLambdaThreadStrand::isRunningInThisThread() const
+{
+	return m_data->isRunningInThisThread();
+}
+
+QLambdaThreadPool QLambdaThreadStrand::getPool()
+{
+	return m_data->getPool();
+}
@@ -0,0 +1,55 @@
+#ifndef QLAMBDATHREADSTRAND_H
+#define QLAMBDATHREADSTRAND_H
+
+#include <QExplicitlySharedDataPointer>
+#include <QDeferred>
+#include "qlambdathreadworker.h"
+#include "qlambdathreadstranddata.h"
+
+// serialized queue of tasks multiplexed over the threads of a pool, many strands can share a few threads
+// NOTE : * tasks of a strand are executed in posting order and never concurrently, although consecutive
+//          tasks can run in different threads of the pool (the strand hands over with a happens-before)
+//        * a strand gives its thread to other strands after QLAMBDATHREADSTRAND_MAX_BATCH tasks in a row
+//        * deferreds returned by run are resolved in a pool thread, callbacks are executed with the usual
+//          QDeferred semantics, i.e. in the thread in which they were registered (e.g. the caller's)
+//        * no QObject affinity or loops, use a worker of the pool for that
+class QLambdaThreadStrand
+{
+public:
+	// constructors
+	QLambdaThreadStrand(const QLambdaThreadPool &pool);
+	QLambdaThreadStrand(const QLambdaThreadStrand &other);
+	QLambdaThreadStrand &operator=(const QLambdaThreadStrand &rhs);
+	~QLambdaThreadStrand();
+
+	bool              execInThread(const std::function<void()> &threadFunc);
+
+	// exec function in strand, returned deferred gets resolved with its return value or rejected if it throws
+	template<typename F>
+	typename QLambdaThreadWorkerRun<typename std::decay<typename std::result_of<F()>::type>::type>::Deferred run(F &&threadFunc);
+
+	// number of tasks waiting to be executed
+	int               getPendingCount();
+
+	// true if called from a task of this strand
+	bool              isRunningInThisThread() const;
+
+	QLambdaThreadPool getPool();
+
+protected:
+	QExplicitlySharedDataPointer<QLambdaThreadStrandData> m_data;
+
+};
+
+template<typename F>
+typename QLambdaThreadWorkerRun<typename std::decay<typename std::result_of<F()>::type>::type>::Deferred QLambdaThreadStrand::run(F &&threadFunc)
+{
+	typedef typename std::decay<typename std::result_of<F()>::type>::type R;
+	auto p_task    = new QLambdaThreadWorkerRunTask<typename std::decay<F>::type, R>(std::forward<F>(threadFunc));
+	auto retDefer  = p_task->m_defer;
+	// pool quitting, task deleted without being executed (rejected)
+	m_data->execNodeInThread(p_task);
+	return retDefer;
+}
+
+#endif // QLAMBDATHREADSTRAND_H
@@ -0,0 +1,125 @@
+#include "qlambdathreadstranddata.h"
+#include <exception>
+
+QLambdaThreadStrandData::QLambdaThreadStrandData(const QLambdaThreadPool &pool) :
+	m_pool(pool),
+	m_scheduled(false),
+	mp_runningThread(nullptr)
+{
+
+}
+
+QLambdaThreadStrandData::QLambdaThreadStrandData(const QLambdaThreadStrandData &other) :
+	QSharedData(other),
+	m_pool(other.m_pool),
+	m_scheduled(false),
+	mp_runningThread(nullptr)
+{
+
+}
+
+QLambdaThreadStrandData::~QLambdaThreadStrandData()
+{
+	// NOTE : a queued drain holds a reference, so only tasks that can never run are left here
+	this->dropPending();
+}
+
+bool QLambdaThreadStrandData::execInThread(const std::function<void()> &threadFunc)
+{
+	return this->execNodeInThread(new QEventMailboxTask<std::function<void()>>(threadFunc));
+}
+
+bool QLambdaThreadStrandData::execNodeInThread(QEventMailboxNode * p_node)
+{
+	{
+		QMutexLocker locker(&m_mutex);
+		m_nodes.append(p_node);
+		// drain already pending, it will pick this task in order
+		if (m_scheduled)
+		{
+			return true;
+		}
+		m_scheduled = true;
+	}
+	if (this->schedule())
+	{
+		return true;
+	}
+	this->dropPending();
+	return false;
+}
+
+int QLambdaThreadStrandData::getPendingCount()
+{
+	QMutexLocker locker(&m_mutex);
+	return m_nodes.count();
+}
+
+bool QLambdaThreadStrandData::isRunningInThisThread() const
+{
+	return mp_runningThread.loadAcquire() == QThread::currentThread();
+}
+
+QLambdaThreadPool QLambdaThreadStrandData::getPool()
+{
+	return m_pool;
+}
+
+bool QLambdaThreadStrandData::schedule()
+{
+	QExplicitlySharedDataPointer<QLambdaThreadStrandData> p_self(this);
+	return m_pool.execInThread([p_self]() {
+		p_self->drain();
+	});
+}
+
+void QLambdaThreadStrandData::drain()
+{
+	mp_runningThread.storeRelease(QThread::currentThread());
+	for (int i = 0; i < QLAMBDATHREADSTRAND_MAX_BATCH; i++)
+	{
+		QEventMailboxNode * p_node = nullptr;
+		{
+			QMutexLocker locker(&m_mutex);
+			if (m_nodes.isEmpty())
+			{
+				m_scheduled = false;
+				mp_runningThread.storeRelease(nullptr);
+				return;
+			}
+			p_node = m_nodes.takeFirst();
+		}
+		// exceptions must not stall the strand (it would stay scheduled forever)
+		try
+		{
+			p_node->exec();
+		}
+		catch (const std::exception &e)
+		{
+			qWarning() << "QLambdaThreadStrand : Exception thrown," << e.what();
+		}
+		catch (...)
+		{
+			qWarning() << "QLambdaThreadStrand : Unknown exception thrown.";
+		}
+		delete p_node;
+	}
+	mp_runningThread.storeRelease(nullptr);
+	// NOTE : still scheduled, so no other drain can start before this one is queued
+	if (!this->schedule())
+	{
+		this->dropPending();
+	}
+}
+
+void QLambdaThreadStrandData::dropPending()
+{
+	QList<QEventMailboxNode *> listNodes;
+	{
+		QMutexLocker locker(&m_mutex);
+		listNodes.swap(m_nodes);
+		m_scheduled = false;
+	}
+	// deleted outside the lock, run tasks reject their deferred when deleted
+	qDeleteAll(listNodes);
+}
@@ -0,0 +1,55 @@
+#ifndef QLAMBDATHREADSTRANDDATA_H
+#define QLAMBDATHREADSTRANDDATA_H
+
+#include <QSharedData>
+#include <QExplicitlySharedDataPointer>
+#include <QThread>
+#include <QMutex>
+#include <QList>
+#include <QAtomicPointer>
+#include <functional>
+
+#include "qeventmailbox.hpp"
+#include "qlambdathreadpool.h"
+
+// max number of tasks executed by a strand before giving its pool thread to other strands
+#define QLAMBDATHREADSTRAND_MAX_BATCH 64
+
+// QLAMBDATHREADSTRANDDATA ----------------------------------------------------
+
+class QLambdaThreadStrandData : public QSharedData
+{
+public:
+	QLambdaThreadStrandData(const QLambdaThreadPool &pool);
+	QLambdaThreadStrandData(const QLambdaThreadStrandData &other);
+	~QLambdaThreadStrandData();
+
+	bool              execInThread(const std::function<void()> &threadFunc);
+
+	// takes ownership, node deleted without being executed if the pool is quitting
+	bool              execNodeInThread(QEventMailboxNode * p_node);
+
+	int               getPendingCount();
+
+	bool              isRunningInThisThread() const;
+
+	QLambdaThreadPool getPool();
+
+private:
+	QLambdaThreadPool          m_pool;
+	// pending tasks, protected by m_mutex
+	QMutex                     m_mutex;
+	QList<QEventMailboxNode *> m_nodes;
+	// a drain is queued in the pool or running, protected by m_mutex
+	bool                       m_scheduled;
+	// pool thread currently executing the strand's tasks
+	QAtomicPointer<QThread>    mp_runningThread;
+	// queue drain in the pool, keeps a reference so data outlives it
+	bool schedule();
+	// execute a batch of tasks, then reschedule if more are pending (runs in a pool thread)
+	void drain();
+	// delete pending tasks that will never be executed
+	void dropPending();
+};
+
+#endif // QLAMBDATHREADSTRANDDATA_H
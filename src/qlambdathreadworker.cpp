@@ -5,6 +5,11 @@ QLambdaThreadWorker::QLambdaThreadWorker() : m_data(nullptr)
 	m_data = QExplicitlySharedDataPointer<QLambdaThreadWorkerData>(new QLambdaThreadWorkerData());
 }
 
+QLambdaThreadWorker::QLambdaThreadWorker(const QLambdaThreadWorkerOptions &options) : m_data(nullptr)
+{
+	m_data = QExplicitlySharedDataPointer<QLambdaThreadWorkerData>(new QLambdaThreadWorkerData(options));
+}
+
 QLambdaThreadWorker::QLambdaThreadWorker(const QLambdaThreadWorker &other) : m_data(other.m_data)
 {
 	m_data.reset();
@@ -30,6 +35,80 @@ bool QLambdaThreadWorker::execInThread(const std::function<void()> &threadFunc,
 	return m_data->execInThread(threadFunc, priority);
 }
 
+bool QLambdaThreadWorker::execInThreadAtLevel(const std::function<void()> &threadFunc, const int &intLevel)
+{
+	return m_data->execInThreadAtLevel(threadFunc, intLevel);
+}
+
+bool QLambdaThreadWorker::execInThreadWithDeadline(const std::function<void()> &threadFunc, const qint64 &usBudget)
+{
+	return m_data->execInThreadWithDeadline(threadFunc, usBudget);
+}
+
+bool QLambdaThreadWorker::execBatchInThread(const QList<std::function<void()>> &listThreadFuncs, const int &intYieldEvery/* = 0*/)
+{
+	return m_data->execBatchInThread(listThreadFuncs, intYieldEvery);
+}
+
+QLambdaThreadWorkerStats QLambdaThreadWorker::getStats() const
+{
+	return m_data->getStats();
+}
+
+QList<QLambdaThreadWorkerLevelMetrics> QLambdaThreadWorker::getLevelMetrics() const
+{
+	return m_data->getLevelMetrics();
+}
+
+void QLambdaThreadWorker::setTracingEnabled(const bool &enabled)
+{
+	m_data->setTracingEnabled(enabled);
+}
+
+bool QLambdaThreadWorker::isTracingEnabled() const
+{
+	return m_data->isTracingEnabled();
+}
+
+QLambdaThreadWorkerLatencyStats QLambdaThreadWorker::getQueueWaitStats() const
+{
+	return m_data->getQueueWaitStats();
+}
+
+QLambdaThreadWorkerLatencyStats QLambdaThreadWorker::getRunTimeStats() const
+{
+	return m_data->getRunTimeStats();
+}
+
+void QLambdaThreadWorker::resetTracing()
+{
+	m_data->resetTracing();
+}
+
+QByteArray QLambdaThreadWorker::getChromeTrace()
+{
+	return QLambdaThreadWorker::getChromeTrace(QList<QLambdaThreadWorker>() << *this);
+}
+
+QByteArray QLambdaThreadWorker::getChromeTrace(const QList<QLambdaThreadWorker> &listWorkers)
+{
+	QByteArray byteEvents;
+	for (int i = 0; i < listWorkers.count(); i++)
+	{
+		QByteArray byteWorkerEvents = listWorkers.at(i).m_data->getChromeTraceEvents();
+		if (byteWorkerEvents.isEmpty())
+		{
+			continue;
+		}
+		if (!byteEvents.isEmpty())
+		{
+			byteEvents += ",\n";
+		}
+		byteEvents += byteWorkerEvents;
+	}
+	return "{\"traceEvents\":[\n" + byteEvents + "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
 QString QLambdaThreadWorker::getThreadId()
 {
 	return m_data->getThreadId();
@@ -45,6 +124,11 @@ int QLambdaThreadWorker::startLoopInThread(const std::function<void()> &threadLo
 	return m_data->startLoopInThread(threadLoopFunc, uiMsSleep);
 }
 
+int QLambdaThreadWorker::startLoopInThread(const std::function<void(const QLambdaThreadWorkerLoopTick&)> &threadLoopFunc, const QLambdaThreadWorkerLoopOptions &options)
+{
+	return m_data->startLoopInThread(threadLoopFunc, options);
+}
+
 QDefer QLambdaThreadWorker::stopLoopInThread(const int &intLoopId)
 {
 	return m_data->stopLoopInThread(intLoopId);
@@ -64,3 +148,8 @@ QDefer QLambdaThreadWorker::quitThread()
 {
 	return m_data->quitThread();
 }
+
+QDeferred<quint32> QLambdaThreadWorker::quitThread(const QLambdaThreadWorkerQuitOptions &options)
+{
+	return m_data->quitThread(options);
+}
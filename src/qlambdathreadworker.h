@@ -3,36 +3,191 @@
 
 #include <QExplicitlySharedDataPointer>
 #include <QDeferred>
+#include <exception>
+#include <type_traits>
 #include "qlambdathreadworkerdata.h"
 
+// deferred type returned by QLambdaThreadWorker::run, QDeferred<R> or QDefer if the function returns void
+template<typename R>
+struct QLambdaThreadWorkerRun
+{
+	typedef QDeferred<R> Deferred;
+
+	template<typename F>
+	static void exec(F &func, Deferred &defer)
+	{
+		defer.resolve(func());
+	}
+	// NOTE : fail callbacks need an argument, use default value if possible, else only failZero callbacks are called
+	static void reject(Deferred &defer)
+	{
+		QLambdaThreadWorkerRun<R>::rejectDefault(defer, std::is_default_constructible<R>());
+	}
+	static void rejectDefault(Deferred &defer, std::true_type)
+	{
+		defer.reject(R());
+	}
+	static void rejectDefault(Deferred &defer, std::false_type)
+	{
+		defer.rejectZero();
+	}
+};
+
+template<>
+struct QLambdaThreadWorkerRun<void>
+{
+	typedef QDefer Deferred;
+
+	template<typename F>
+	static void exec(F &func, Deferred &defer)
+	{
+		func();
+		defer.resolve();
+	}
+	static void reject(Deferred &defer)
+	{
+		defer.reject();
+	}
+};
+
+// mailbox node containing both the function and its deferred, so run() needs no wrapper lambda
+// NOTE : the shared data of the deferred is still allocated separately
+template<typename F, typename R>
+class QLambdaThreadWorkerRunTask : public QEventMailboxNode
+{
+public:
+	typedef typename QLambdaThreadWorkerRun<R>::Deferred Deferred;
+
+	QLambdaThreadWorkerRunTask(F &&func) : m_func(std::move(func)), m_executed(false) { }
+	QLambdaThreadWorkerRunTask(const F &func) : m_func(func), m_executed(false) { }
+	// task dropped when quitting, reject so the caller does not wait forever
+	~QLambdaThreadWorkerRunTask()
+	{
+		if (!m_executed)
+		{
+			QLambdaThreadWorkerRun<R>::reject(m_defer);
+		}
+	}
+
+	void exec()
+	{
+		m_executed = true;
+		// exceptions must not leave the event loop, reject instead
+		try
+		{
+			QLambdaThreadWorkerRun<R>::exec(m_func, m_defer);
+		}
+		catch (const std::exception &e)
+		{
+			qWarning() << "QLambdaThreadWorker::run : Exception thrown," << e.what();
+			QLambdaThreadWorkerRun<R>::reject(m_defer);
+		}
+		catch (...)
+		{
+			qWarning() << "QLambdaThreadWorker::run : Unknown exception thrown.";
+			QLambdaThreadWorkerRun<R>::reject(m_defer);
+		}
+	}
+
+	F        m_func;
+	Deferred m_defer;
+	bool     m_executed;
+};
+
 class QLambdaThreadWorker
 {
 public:
 	// constructors
 	QLambdaThreadWorker();
+	explicit QLambdaThreadWorker(const QLambdaThreadWorkerOptions &options);
 	QLambdaThreadWorker(const QLambdaThreadWorker &other);
 	QLambdaThreadWorker &operator=(const QLambdaThreadWorker &rhs);
 	~QLambdaThreadWorker();
 
+	// Qt::HighEventPriority, Qt::NormalEventPriority and Qt::LowEventPriority map to levels 6, 3 and 0
 	bool      execInThread(const std::function<void()> &threadFunc, const Qt::EventPriority &priority = Qt::NormalEventPriority);
 
+	// exec function in thread after pending functions of higher levels, in FIFO order within the level
+	// (0 to QLAMBDATHREADWORKER_PRIORITY_LEVELS - 1, higher first)
+	// NOTE : priority is strict, a level with a steady stream of functions starves the lower ones
+	bool      execInThreadAtLevel(const std::function<void()> &threadFunc, const int &intLevel);
+
+	// exec function in thread before any level, functions with deadline run earliest deadline first,
+	// the deadline being usBudget microseconds from now
+	bool      execInThreadWithDeadline(const std::function<void()> &threadFunc, const qint64 &usBudget);
+
+	// exec all functions in thread as a single unit (one queue operation), in order, if intYieldEvery > 0 the
+	// event loop gets to run every intYieldEvery functions and the rest is queued again behind the callbacks
+	// queued meanwhile, to keep latency of other callbacks, loops and events bounded
+	// NOTE : the batch counts as one callback in the stats, whatever intYieldEvery
+	bool      execBatchInThread(const QList<std::function<void()>> &listThreadFuncs, const int &intYieldEvery = 0);
+
+	// exec function in thread, returned deferred gets resolved with its return value or rejected if it throws
+	template<typename F>
+	typename QLambdaThreadWorkerRun<typename std::decay<typename std::result_of<F()>::type>::type>::Deferred run(F &&threadFunc);
+
+	// statistics of queued and executed callbacks, safe to call from any thread
+	QLambdaThreadWorkerStats getStats() const;
+
+	// queue depths of each level plus deadline and internal control pseudo levels, safe to call from any thread
+	QList<QLambdaThreadWorkerLevelMetrics> getLevelMetrics() const;
+
+	// stamp callbacks at enqueue, start and end to keep histograms of queue wait and run time, plus
+	// the timing of the last QLAMBDATHREADWORKERTRACE_CAPACITY callbacks for the chrome trace export
+	void      setTracingEnabled(const bool &enabled);
+
+	bool      isTracingEnabled() const;
+
+	// enqueue to start of traced callbacks, safe to call from any thread
+	QLambdaThreadWorkerLatencyStats getQueueWaitStats() const;
+
+	// start to end of traced callbacks, safe to call from any thread
+	QLambdaThreadWorkerLatencyStats getRunTimeStats() const;
+
+	void      resetTracing();
+
+	// chrome trace event json of the traced callbacks (chrome://tracing, perfetto), one track per worker
+	QByteArray getChromeTrace();
+	static QByteArray getChromeTrace(const QList<QLambdaThreadWorker> &listWorkers);
+
 	QString   getThreadId();
 
 	QThread * getThread();
 
+	// loops are kept in a timer queue of the worker, start and stop can be called from any thread
 	int       startLoopInThread(const std::function<void()> &threadLoopFunc, const quint32 &uiMsSleep = 1000);
 
+	// loop with precise period and catch-up policy, loop function receives the timing of each tick
+	int       startLoopInThread(const std::function<void(const QLambdaThreadWorkerLoopTick &)> &threadLoopFunc, const QLambdaThreadWorkerLoopOptions &options);
+
 	QDefer    stopLoopInThread(const int &intLoopId);
 
 	QDefer    stopAllLoopsInThread();
 
 	bool      moveQObjectToThread(QObject * pObject);
 
+	// stop loops, execute pending callbacks and quit
 	QDefer    quitThread();
+	// quit according to policy, resolved with the number of callbacks dropped once the thread finished
+	QDeferred<quint32> quitThread(const QLambdaThreadWorkerQuitOptions &options);
 
 protected:
 	QExplicitlySharedDataPointer<QLambdaThreadWorkerData> m_data;
 
 };
 
+template<typename F>
+typename QLambdaThreadWorkerRun<typename std::decay<typename std::result_of<F()>::type>::type>::Deferred QLambdaThreadWorker::run(F &&threadFunc)
+{
+	typedef typename std::decay<typename std::result_of<F()>::type>::type R;
+	auto p_task    = new QLambdaThreadWorkerRunTask<typename std::decay<F>::type, R>(std::forward<F>(threadFunc));
+	auto retDefer  = p_task->m_defer;
+	// thread not running, task never executed (rejected once, when deleted)
+	if (!m_data->execNodeInThread(p_task))
+	{
+		delete p_task;
+	}
+	return retDefer;
+}
+
 #endif // QLAMBDATHREADWORKER_H
\ No newline at end of file
@@ -7,8 +7,30 @@ INCLUDEPATH += $$PWD/
     include($$PWD/qdeferred.pri)
 }
 
-HEADERS  += $$PWD/qlambdathreadworkerdata.h \
-            $$PWD/qlambdathreadworker.h
+HEADERS  += $$PWD/qlambdathreadworkertrace.h \
+            $$PWD/qlambdathreadworkerdata.h \
+            $$PWD/qlambdathreadworker.h \
+            $$PWD/qlambdathreadpooldata.h \
+            $$PWD/qlambdathreadpool.h \
+            $$PWD/qlambdathreadspinworkerdata.h \
+            $$PWD/qlambdathreadspinworker.h \
+            $$PWD/qlambdathreadparalleldata.h \
+            $$PWD/qlambdathreadparallel.h \
+            $$PWD/qlambdathreadstranddata.h \
+            $$PWD/qlambdathreadstrand.h \
+            $$PWD/qlambdathreadring.hpp \
+            $$PWD/qlambdathreadpipelinedata.h \
+            $$PWD/qlambdathreadpipeline.h
 
-SOURCES  += $$PWD/qlambdathreadworkerdata.cpp \
-            $$PWD/qlambdathreadworker.cpp
\ No newline at end of file
+SOURCES  += $$PWD/qlambdathreadworkertrace.cpp \
+            $$PWD/qlambdathreadworkerdata.cpp \
+            $$PWD/qlambdathreadworker.cpp \
+            $$PWD/qlambdathreadpooldata.cpp \
+            $$PWD/qlambdathreadpool.cpp \
+            $$PWD/qlambdathreadspinworkerdata.cpp \
+            $$PWD/qlambdathreadspinworker.cpp \
+            $$PWD/qlambdathreadparalleldata.cpp \
+            $$PWD/qlambdathreadparallel.cpp \
+            $$PWD/qlambdathreadstranddata.cpp \
+            $$PWD/qlambdathreadstrand.cpp \
+            $$PWD/qlambdathreadpipelinedata.cpp
\ No newline at end of file
@@ -1,10 +1,152 @@
 #include "qlambdathreadworkerdata.h"
 #include <QCoreApplication>
+#include <QElapsedTimer>
 #include <sstream>
+#include <algorithm>
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
 
-// QDEFTHREADWORKERDATAEVENT -------------------------------------------------
+// QLAMBDATHREADWORKERTIMERQUEUE --------------------------------------------
 
-QLambdaThreadWorkerDataEvent::QLambdaThreadWorkerDataEvent() : QEvent(QLAMBDATHREADWORKERDATA_EVENT_TYPE)
+void QLambdaThreadWorkerTimerQueue::push(const QSharedPointer<QLambdaThreadWorkerLoop> &p_loop)
+{
+	p_loop->heapIndex = m_heap.count();
+	m_heap.append(p_loop);
+	this->siftUp(p_loop->heapIndex);
+}
+
+QSharedPointer<QLambdaThreadWorkerLoop> QLambdaThreadWorkerTimerQueue::pop()
+{
+	if (m_heap.isEmpty())
+	{
+		return QSharedPointer<QLambdaThreadWorkerLoop>();
+	}
+	QSharedPointer<QLambdaThreadWorkerLoop> p_loop = m_heap.first();
+	this->remove(p_loop);
+	return p_loop;
+}
+
+void QLambdaThreadWorkerTimerQueue::remove(const QSharedPointer<QLambdaThreadWorkerLoop> &p_loop)
+{
+	int index = p_loop->heapIndex;
+	Q_ASSERT_X(index >= 0 && index < m_heap.count() && m_heap.at(index) == p_loop, "QLambdaThreadWorkerTimerQueue::remove", "Loop not queued.");
+	int last = m_heap.count() - 1;
+	if (index != last)
+	{
+		this->swap(index, last);
+	}
+	m_heap.removeLast();
+	p_loop->heapIndex = -1;
+	if (index != last)
+	{
+		// moved element can go either way
+		this->siftUp(index);
+		this->siftDown(index);
+	}
+}
+
+QSharedPointer<QLambdaThreadWorkerLoop> QLambdaThreadWorkerTimerQueue::top() const
+{
+	if (m_heap.isEmpty())
+	{
+		return QSharedPointer<QLambdaThreadWorkerLoop>();
+	}
+	return m_heap.first();
+}
+
+int QLambdaThreadWorkerTimerQueue::count() const
+{
+	return m_heap.count();
+}
+
+void QLambdaThreadWorkerTimerQueue::siftUp(int index)
+{
+	while (index > 0)
+	{
+		int parent = (index - 1) / 2;
+		if (m_heap.at(parent)->nextNs <= m_heap.at(index)->nextNs)
+		{
+			return;
+		}
+		this->swap(parent, index);
+		index = parent;
+	}
+}
+
+void QLambdaThreadWorkerTimerQueue::siftDown(int index)
+{
+	int count = m_heap.count();
+	forever
+	{
+		int smallest = index;
+		int left     = 2 * index + 1;
+		int right    = left + 1;
+		if (left < count && m_heap.at(left)->nextNs < m_heap.at(smallest)->nextNs)
+		{
+			smallest = left;
+		}
+		if (right < count && m_heap.at(right)->nextNs < m_heap.at(smallest)->nextNs)
+		{
+			smallest = right;
+		}
+		if (smallest == index)
+		{
+			return;
+		}
+		this->swap(smallest, index);
+		index = smallest;
+	}
+}
+
+void QLambdaThreadWorkerTimerQueue::swap(const int &indexA, const int &indexB)
+{
+	std::swap(m_heap[indexA], m_heap[indexB]);
+	m_heap[indexA]->heapIndex = indexA;
+	m_heap[indexB]->heapIndex = indexB;
+}
+
+// QLAMBDATHREADWORKEROPTIONS -----------------------------------------------
+
+QLambdaThreadWorkerOptions::QLambdaThreadWorkerOptions(const QString &name/* = QString()*/, 
+	                                                   const QThread::Priority &priority/* = QThread::InheritPriority*/,
+	                                                   const uint &stackSize/* = 0*/,
+	                                                   const QList<int> &cpuAffinity/* = QList<int>()*/) :
+	name(name),
+	priority(priority),
+	stackSize(stackSize),
+	cpuAffinity(cpuAffinity)
+{
+	// nothing to do here
+}
+
+// QLAMBDATHREADWORKERQUITOPTIONS -------------------------------------------
+
+QLambdaThreadWorkerQuitOptions::QLambdaThreadWorkerQuitOptions(const Policy &policy/* = CancelLoopsThenDrain*/, const qint64 &msDeadline/* = -1*/) :
+	policy(policy),
+	msDeadline(msDeadline)
+{
+	// nothing to do here
+}
+
+// QLAMBDATHREADWORKERLOOPOPTIONS -------------------------------------------
+
+QLambdaThreadWorkerLoopOptions::QLambdaThreadWorkerLoopOptions(const quint64 &periodUs/* = 1000000*/, 
+	                                                           const Qt::TimerType &timerType/* = Qt::PreciseTimer*/, 
+	                                                           const Schedule &schedule/* = FixedRate*/, 
+	                                                           const MissedTicks &missedTicks/* = Skip*/) :
+	periodUs(periodUs),
+	timerType(timerType),
+	schedule(schedule),
+	missedTicks(missedTicks)
+{
+	// nothing to do here
+}
+
+QLambdaThreadWorkerQuitEvent::QLambdaThreadWorkerQuitEvent(const QLambdaThreadWorkerQuitOptions &options) : 
+	QEvent(QLAMBDATHREADWORKERDATA_QUIT_EVENT_TYPE),
+	m_options(options)
 {
 	// nothing to do here
 }
@@ -13,75 +155,613 @@ QLambdaThreadWorkerDataEvent::QLambdaThreadWorkerDataEvent() : QEvent(QLAMBDATHR
 
 QLambdaThreadWorkerObjectData::QLambdaThreadWorkerObjectData() : 
 	QObject(nullptr),
-	m_callbacksToExec(0)
+	m_quitRequested(0),
+	m_quitting(false),
+	m_quitDone(false),
+	m_quitDeadlineNs(-1),
+	m_quitTimerId(-1),
+	m_dropped(0),
+	m_loopIdCounter(0),
+	m_timerId(-1),
+	m_armRequested(0),
+	m_deadlineSequence(0),
+	m_deadlineMisses(0),
+	m_callbacksToExec(0),
+	m_submitted(0),
+	m_executed(0),
+	m_uncountedExecuted(0),
+	m_maxDepth(0),
+	m_busyNs(0),
+	// NOTE : strict priority (no streak limit), so levels and deadlines keep their order under load
+	m_mailbox(this, QLAMBDATHREADWORKERDATA_MAILBOX_EVENT_TYPE, QLambdaThreadWorkerObjectData::lanePriorities(), 0)
 {
-	// nothing to do here either
+	m_clock.start();
+	// quit once every callback is processed (only if quitting)
+	QObject::connect(this, &QLambdaThreadWorkerObjectData::finishedProcessingCallbacks, this, [this]() {
+		this->checkQuit();
+	}, Qt::DirectConnection);
 }
 
 void QLambdaThreadWorkerObjectData::timerEvent(QTimerEvent *event)
 {
-	// get timer id and execute related function
-	int timerId = event->timerId();
-	// check if map contains such timer, of not return
-	if (!m_mapFuncs.contains(timerId))
+	if (event->timerId() == m_quitTimerId)
 	{
+		this->killTimer(m_quitTimerId);
+		m_quitTimerId = -1;
+		this->checkQuit();
 		return;
 	}
-	// if timer exists, exec function
-	m_mapFuncs[timerId]();
+	// only other timer is the one of the timer queue
+	if (event->timerId() != m_timerId)
+	{
+		return;
+	}
+	this->killTimer(m_timerId);
+	m_timerId = -1;
+	// execute due loops
+	QElapsedTimer timer;
+	timer.start();
+	this->serviceTimerQueue();
+	m_busyNs.fetchAndAddRelaxed(timer.nsecsElapsed());
 }
 
 bool QLambdaThreadWorkerObjectData::event(QEvent * ev)
 {
-	if (ev->type() == QLAMBDATHREADWORKERDATA_EVENT_TYPE) {
-		// call function
-		static_cast<QLambdaThreadWorkerDataEvent*>(ev)->m_eventFunc();
-		// decrement callback count
-		this->decrementCallbackCount();
+	if (ev->type() == QLAMBDATHREADWORKERDATA_MAILBOX_EVENT_TYPE) {
+		// call all queued functions
+		QElapsedTimer timer;
+		timer.start();
+		int count = this->drainMailbox();
+		m_busyNs.fetchAndAddRelaxed(timer.nsecsElapsed());
+		// decrement callback count once per batch
+		if (count > 0)
+		{
+			this->decrementCallbackCount(count);
+		}
+		if (m_quitting)
+		{
+			this->checkQuit();
+		}
 		// return event processed
 		return true;
 	}
+	if (ev->type() == QLAMBDATHREADWORKERDATA_QUIT_EVENT_TYPE) {
+		this->beginQuit(static_cast<QLambdaThreadWorkerQuitEvent*>(ev)->m_options);
+		return true;
+	}
 	// Call base implementation (make sure the rest of events are handled)
 	return QObject::event(ev);
 }
 
-quint32 QLambdaThreadWorkerObjectData::incrementCallbackCount()
+int QLambdaThreadWorkerObjectData::drainMailbox()
+{
+	if (m_quitDone)
+	{
+		// already counted as dropped when quitting
+		m_callbacksToExec.fetchAndSubOrdered(m_mailbox.discard());
+		return 0;
+	}
+	if (m_quitDeadlineNs < 0)
+	{
+		return m_mailbox.drain(1024, &m_quitRequested);
+	}
+	// check deadline between callbacks, rest is dropped by checkQuit
+	int count = 0;
+	while (count < 1024 && !this->isPastQuitDeadline())
+	{
+		int executed = m_mailbox.drain(1);
+		if (executed == 0)
+		{
+			break;
+		}
+		count += executed;
+	}
+	return count;
+}
+
+void QLambdaThreadWorkerObjectData::requestQuit()
 {
-	QMutexLocker locker(&m_mutex);
-	return ++m_callbacksToExec;
+	m_quitRequested.storeRelease(1);
 }
 
-quint32 QLambdaThreadWorkerObjectData::decrementCallbackCount()
+void QLambdaThreadWorkerObjectData::beginQuit(const QLambdaThreadWorkerQuitOptions &options)
 {
-	m_mutex.lock();
-	--m_callbacksToExec;
-	m_mutex.unlock();
-	if (m_callbacksToExec == 0)
+	m_quitRequested.storeRelease(0);
+	m_quitting    = true;
+	m_quitOptions = options;
+	if (options.msDeadline >= 0)
+	{
+		m_quitDeadlineNs = m_clock.nsecsElapsed() + options.msDeadline * 1000000;
+		m_quitTimerId    = this->startTimer((int)options.msDeadline, Qt::PreciseTimer);
+	}
+	if (options.policy != QLambdaThreadWorkerQuitOptions::DrainAll)
+	{
+		// NOTE : in this thread, so no loop is executing and stopping is immediate
+		this->stopAllLoops();
+	}
+	this->checkQuit();
+}
+
+bool QLambdaThreadWorkerObjectData::isPastQuitDeadline() const
+{
+	return m_quitDeadlineNs >= 0 && m_clock.nsecsElapsed() >= m_quitDeadlineNs;
+}
+
+void QLambdaThreadWorkerObjectData::checkQuit()
+{
+	if (!m_quitting || m_quitDone)
+	{
+		return;
+	}
+	bool isDrop = m_quitOptions.policy == QLambdaThreadWorkerQuitOptions::DropPending || this->isPastQuitDeadline();
+	if (!isDrop && m_callbacksToExec.loadAcquire() > 0)
+	{
+		// keep draining
+		return;
+	}
+	m_quitDone = true;
+	this->stopAllLoops();
+	if (m_quitTimerId >= 0)
+	{
+		this->killTimer(m_quitTimerId);
+		m_quitTimerId = -1;
+	}
+	// callbacks still queued are never executed, tasks in the mailbox are deleted right away
+	// so their resources (and deferreds) are released before the thread finishes
+	m_dropped.storeRelease(m_callbacksToExec.loadAcquire());
+	m_callbacksToExec.fetchAndSubOrdered(m_mailbox.discard());
+	this->thread()->quit();
+}
+
+quint32 QLambdaThreadWorkerObjectData::droppedCount() const
+{
+	return m_dropped.loadAcquire();
+}
+
+quint32 QLambdaThreadWorkerObjectData::incrementCallbackCount(const bool &isCounted/* = true*/)
+{
+	if (isCounted)
+	{
+		m_submitted.fetchAndAddRelaxed(1);
+	}
+	quint32 depth = m_callbacksToExec.fetchAndAddOrdered(1) + 1;
+	// keep maximum depth
+	quint32 maxDepth = m_maxDepth.loadAcquire();
+	while (depth > maxDepth && !m_maxDepth.testAndSetOrdered(maxDepth, depth, maxDepth))
+	{
+		// maxDepth updated with current value, try again
+	}
+	return depth;
+}
+
+quint32 QLambdaThreadWorkerObjectData::decrementCallbackCount(const quint32 &count/* = 1*/)
+{
+	m_executed.fetchAndAddRelaxed(count - qMin(count, m_uncountedExecuted));
+	m_uncountedExecuted = 0;
+	// NOTE : use the value returned by the atomic operation, only the call that reaches zero emits
+	quint32 remaining = m_callbacksToExec.fetchAndSubOrdered(count) - count;
+	if (remaining == 0)
 	{
 		emit this->finishedProcessingCallbacks();
 	}
-	return m_callbacksToExec;
+	return remaining;
+}
+
+int QLambdaThreadWorkerObjectData::startLoop(const std::function<void(const QLambdaThreadWorkerLoopTick&)> &threadLoopFunc, const QLambdaThreadWorkerLoopOptions &options)
+{
+	QSharedPointer<QLambdaThreadWorkerLoop> p_loop(new QLambdaThreadWorkerLoop);
+	p_loop->loopId        = m_loopIdCounter.fetchAndAddRelaxed(1) + 1;
+	p_loop->loopFunc      = threadLoopFunc;
+	p_loop->options       = options;
+	p_loop->options.periodUs = qMax(options.periodUs, (quint64)1);
+	p_loop->startNs       = m_clock.nsecsElapsed();
+	p_loop->nextNs        = p_loop->startNs + (qint64)p_loop->options.periodUs * 1000;
+	p_loop->pendingMissed = 0;
+	p_loop->tick          = QLambdaThreadWorkerLoopTick();
+	p_loop->heapIndex     = -1;
+	p_loop->stopped       = false;
+	bool isFirst;
+	{
+		QMutexLocker locker(&m_loopMutex);
+		m_hashLoops[p_loop->loopId] = p_loop;
+		m_timerQueue.push(p_loop);
+		isFirst = p_loop->heapIndex == 0;
+	}
+	// timer only needs to be armed again if new loop is the next one due
+	if (isFirst)
+	{
+		this->requestArmTimerQueue();
+	}
+	return p_loop->loopId;
+}
+
+QDefer QLambdaThreadWorkerObjectData::stopLoop(const int &intLoopId)
+{
+	QDefer retDefer;
+	QMutexLocker locker(&m_loopMutex);
+	QSharedPointer<QLambdaThreadWorkerLoop> p_loop = m_hashLoops.take(intLoopId);
+	if (!p_loop)
+	{
+		locker.unlock();
+		qWarning() << "QLambdaThreadWorker::stopLoopInThread : Invalid loop Id.";
+		retDefer.reject();
+		return retDefer;
+	}
+	p_loop->stopped = true;
+	if (p_loop->heapIndex < 0)
+	{
+		// executing, resolve after tick
+		p_loop->listStopDefers.append(retDefer);
+		return retDefer;
+	}
+	// NOTE : timer is not re-armed, next time it fires it is armed for the new earliest deadline
+	m_timerQueue.remove(p_loop);
+	locker.unlock();
+	retDefer.resolve();
+	return retDefer;
+}
+
+QDefer QLambdaThreadWorkerObjectData::stopAllLoops()
+{
+	QList<QDefer> listDefers;
+	QMutexLocker locker(&m_loopMutex);
+	for (auto it = m_hashLoops.begin(); it != m_hashLoops.end(); ++it)
+	{
+		QSharedPointer<QLambdaThreadWorkerLoop> &p_loop = it.value();
+		p_loop->stopped = true;
+		if (p_loop->heapIndex < 0)
+		{
+			QDefer stopDefer;
+			p_loop->listStopDefers.append(stopDefer);
+			listDefers.append(stopDefer);
+			continue;
+		}
+		m_timerQueue.remove(p_loop);
+	}
+	m_hashLoops.clear();
+	locker.unlock();
+	if (listDefers.isEmpty())
+	{
+		QDefer retDefer;
+		retDefer.resolve();
+		return retDefer;
+	}
+	return QDefer::when(listDefers);
+}
+
+void QLambdaThreadWorkerObjectData::requestArmTimerQueue()
+{
+	if (QThread::currentThread() == this->thread())
+	{
+		this->armTimerQueue();
+		return;
+	}
+	// one pending request is enough, it arms for the earliest deadline at the time it executes
+	if (!m_armRequested.testAndSetOrdered(0, 1))
+	{
+		return;
+	}
+	// NOTE : internal, pending like any callback but not counted in the stats
+	this->incrementCallbackCount(false);
+	this->post([this]() {
+		this->skipExecutedCount();
+		m_armRequested.storeRelease(0);
+		this->armTimerQueue();
+	}, QLAMBDATHREADWORKER_CONTROL_LEVEL);
+}
+
+void QLambdaThreadWorkerObjectData::armTimerQueue()
+{
+	if (m_timerId >= 0)
+	{
+		this->killTimer(m_timerId);
+		m_timerId = -1;
+	}
+	QMutexLocker locker(&m_loopMutex);
+	QSharedPointer<QLambdaThreadWorkerLoop> p_loop = m_timerQueue.top();
+	if (!p_loop)
+	{
+		return;
+	}
+	qint64 remainingNs = p_loop->nextNs - m_clock.nsecsElapsed();
+	int    intMs       = 0;
+	if (remainingNs > 0)
+	{
+		// precise loops wake up before the deadline and spin the event loop for the fraction of millisecond,
+		// other timer types are allowed to be late anyway
+		intMs = p_loop->options.timerType == Qt::PreciseTimer ? 
+			(int)(remainingNs / 1000000) : 
+			(int)((remainingNs + 999999) / 1000000);
+	}
+	m_timerId = this->startTimer(intMs, p_loop->options.timerType);
+}
+
+void QLambdaThreadWorkerObjectData::serviceTimerQueue()
+{
+	// NOTE : only loops due before servicing started are executed, so Burst loops cannot block the thread forever
+	qint64 nowNs = m_clock.nsecsElapsed();
+	forever
+	{
+		m_loopMutex.lock();
+		QSharedPointer<QLambdaThreadWorkerLoop> p_loop = m_timerQueue.top();
+		// coarse timers are allowed to fire up to 5% of the period early
+		qint64 toleranceNs = p_loop && p_loop->options.timerType != Qt::PreciseTimer ? 
+			(qint64)p_loop->options.periodUs * 50 : 0;
+		if (!p_loop || p_loop->nextNs - toleranceNs > nowNs)
+		{
+			m_loopMutex.unlock();
+			break;
+		}
+		m_timerQueue.pop();
+		m_loopMutex.unlock();
+		// execute without lock, so loops can be started or stopped from loop function
+		this->tickLoop(p_loop.data());
+		QList<QDefer> listStopDefers;
+		m_loopMutex.lock();
+		if (p_loop->stopped)
+		{
+			listStopDefers = p_loop->listStopDefers;
+			p_loop->listStopDefers.clear();
+		}
+		else
+		{
+			m_timerQueue.push(p_loop);
+		}
+		m_loopMutex.unlock();
+		for (int i = 0; i < listStopDefers.count(); i++)
+		{
+			listStopDefers[i].resolve();
+		}
+	}
+	this->armTimerQueue();
+}
+
+void QLambdaThreadWorkerObjectData::tickLoop(QLambdaThreadWorkerLoop * p_loop)
+{
+	qint64 nowNs    = m_clock.nsecsElapsed();
+	qint64 periodNs = (qint64)p_loop->options.periodUs * 1000;
+	QLambdaThreadWorkerLoopTick &tick = p_loop->tick;
+	// times relative to loop start
+	tick.scheduledNs  = p_loop->nextNs - p_loop->startNs;
+	tick.startNs      = nowNs - p_loop->startNs;
+	tick.latenessNs   = nowNs - p_loop->nextNs;
+	tick.missedTicks  = p_loop->pendingMissed;
+	tick.totalMissedTicks += p_loop->pendingMissed;
+	p_loop->pendingMissed = 0;
+	p_loop->loopFunc(tick);
+	qint64 endNs = m_clock.nsecsElapsed();
+	tick.lastRunNs = endNs - nowNs;
+	if (tick.lastRunNs > periodNs)
+	{
+		tick.overruns++;
+	}
+	tick.tick++;
+	// schedule next tick
+	if (p_loop->options.schedule == QLambdaThreadWorkerLoopOptions::FixedDelay)
+	{
+		p_loop->nextNs = endNs + periodNs;
+		return;
+	}
+	p_loop->nextNs += periodNs;
+	if (p_loop->nextNs > endNs)
+	{
+		return;
+	}
+	// whole periods already elapsed after next tick
+	qint64 behind = (endNs - p_loop->nextNs) / periodNs;
+	switch (p_loop->options.missedTicks)
+	{
+	case QLambdaThreadWorkerLoopOptions::Skip:
+		// continue on the first tick still in the future
+		p_loop->pendingMissed = behind + 1;
+		p_loop->nextNs += (behind + 1) * periodNs;
+		break;
+	case QLambdaThreadWorkerLoopOptions::Coalesce:
+		// execute right away as the last elapsed tick
+		p_loop->pendingMissed = behind;
+		p_loop->nextNs += behind * periodNs;
+		break;
+	case QLambdaThreadWorkerLoopOptions::Burst:
+		// execute every elapsed tick
+		break;
+	}
+}
+
+void QLambdaThreadWorkerObjectData::skipExecutedCount()
+{
+	m_uncountedExecuted++;
+}
+
+void QLambdaThreadWorkerObjectData::yieldToEventLoop()
+{
+	m_mailbox.yield();
+}
+
+QLambdaThreadWorkerStats QLambdaThreadWorkerObjectData::stats() const
+{
+	QLambdaThreadWorkerStats stats;
+	stats.submitted = m_submitted.loadAcquire();
+	stats.executed  = m_executed.loadAcquire();
+	stats.depth     = m_callbacksToExec.loadAcquire();
+	stats.maxDepth  = m_maxDepth.loadAcquire();
+	stats.busyNs    = m_busyNs.loadAcquire();
+	stats.deadlineMisses = m_deadlineMisses.loadAcquire();
+	return stats;
+}
+
+void QLambdaThreadWorkerObjectData::postNode(QEventMailboxNode * p_node, const int &intLevel/* = QLAMBDATHREADWORKER_NORMAL_LEVEL*/)
+{
+	if (m_trace.isEnabled())
+	{
+		p_node = new QLambdaThreadWorkerTracedTask(p_node, &m_trace);
+	}
+	m_mailbox.postNode(p_node, QLambdaThreadWorkerObjectData::laneForLevel(intLevel));
+}
+
+void QLambdaThreadWorkerObjectData::postDeadline(const std::function<void()> &func, const qint64 &usBudget)
+{
+	DeadlineTask task;
+	task.deadlineNs = m_clock.nsecsElapsed() + usBudget * 1000;
+	task.func       = func;
+	{
+		QMutexLocker locker(&m_deadlineMutex);
+		task.sequence = m_deadlineSequence++;
+		m_deadlineHeap.append(task);
+		std::push_heap(m_deadlineHeap.begin(), m_deadlineHeap.end(), &QLambdaThreadWorkerObjectData::isLaterDeadline);
+	}
+	// NOTE : the node does not execute this task but the earliest one pending when it runs,
+	//        there is one node per task so every task gets executed
+	this->post([this]() {
+		this->execEarliestDeadline();
+	}, QLAMBDATHREADWORKER_DEADLINE_LEVEL);
+}
+
+bool QLambdaThreadWorkerObjectData::isLaterDeadline(const DeadlineTask &taskA, const DeadlineTask &taskB)
+{
+	if (taskA.deadlineNs != taskB.deadlineNs)
+	{
+		return taskA.deadlineNs > taskB.deadlineNs;
+	}
+	return taskA.sequence > taskB.sequence;
+}
+
+void QLambdaThreadWorkerObjectData::execEarliestDeadline()
+{
+	DeadlineTask task;
+	{
+		QMutexLocker locker(&m_deadlineMutex);
+		if (m_deadlineHeap.isEmpty())
+		{
+			return;
+		}
+		std::pop_heap(m_deadlineHeap.begin(), m_deadlineHeap.end(), &QLambdaThreadWorkerObjectData::isLaterDeadline);
+		task = m_deadlineHeap.takeLast();
+	}
+	if (m_clock.nsecsElapsed() > task.deadlineNs)
+	{
+		m_deadlineMisses.fetchAndAddRelaxed(1);
+	}
+	task.func();
+}
+
+QList<QLambdaThreadWorkerLevelMetrics> QLambdaThreadWorkerObjectData::levelMetrics() const
+{
+	QList<QLambdaThreadWorkerLevelMetrics> listMetrics;
+	for (int level = 0; level <= QLAMBDATHREADWORKER_CONTROL_LEVEL; level++)
+	{
+		QLambdaThreadWorkerLevelMetrics metrics;
+		int lane         = QLambdaThreadWorkerObjectData::laneForLevel(level);
+		metrics.level    = level;
+		metrics.depth    = m_mailbox.depth(lane);
+		metrics.maxDepth = m_mailbox.maxDepth(lane);
+		listMetrics.append(metrics);
+	}
+	return listMetrics;
+}
+
+QLambdaThreadWorkerTrace * QLambdaThreadWorkerObjectData::trace()
+{
+	return &m_trace;
+}
+
+int QLambdaThreadWorkerObjectData::levelForPriority(const Qt::EventPriority &priority)
+{
+	return qBound(0, QLAMBDATHREADWORKER_NORMAL_LEVEL + 3 * (int)priority, QLAMBDATHREADWORKER_PRIORITY_LEVELS - 1);
+}
+
+int QLambdaThreadWorkerObjectData::laneForLevel(const int &intLevel)
+{
+	Q_ASSERT_X(intLevel >= 0 && intLevel <= QLAMBDATHREADWORKER_CONTROL_LEVEL, "QLambdaThreadWorkerObjectData::laneForLevel", "Invalid level.");
+	// control lane first, then deadline lane, then levels highest first
+	return QLAMBDATHREADWORKER_CONTROL_LEVEL - intLevel;
+}
+
+QList<int> QLambdaThreadWorkerObjectData::lanePriorities()
+{
+	// priority of the wakeup event of each lane, relative to other Qt events of the thread
+	QList<int> listPriorities;
+	for (int lane = 0; lane <= QLAMBDATHREADWORKER_CONTROL_LEVEL; lane++)
+	{
+		int level = QLAMBDATHREADWORKER_CONTROL_LEVEL - lane;
+		if (level > QLAMBDATHREADWORKER_NORMAL_LEVEL + 1)
+		{
+			listPriorities.append(Qt::HighEventPriority);
+		}
+		else if (level >= QLAMBDATHREADWORKER_NORMAL_LEVEL - 1)
+		{
+			listPriorities.append(Qt::NormalEventPriority);
+		}
+		else
+		{
+			listPriorities.append(Qt::LowEventPriority);
+		}
+	}
+	return listPriorities;
 }
 
 // QDEFTHREADWORKERDATA -----------------------------------------------------
 
-QLambdaThreadWorkerData::QLambdaThreadWorkerData()
+QLambdaThreadWorkerData::QLambdaThreadWorkerData(const QLambdaThreadWorkerOptions &options/* = QLambdaThreadWorkerOptions()*/)
 {
 	mp_workerThread = new QThread;
 	mp_workerObj    = new QLambdaThreadWorkerObjectData;
 	// initial value
 	m_requestedQuit = false;
-	m_intIdCounter  = 0;
 	// get thread id
 	std::stringstream stream;
 	stream << std::hex << (size_t)mp_workerThread;
 	m_strThreadId = "QThread(0x" + QString::fromStdString(stream.str()) + ")";
+	if (!options.name.isEmpty())
+	{
+		m_strThreadId = options.name + " " + m_strThreadId;
+		mp_workerThread->setObjectName(options.name);
+	}
 	// move worker object to thread and subscribe for deletion
 	mp_workerObj->moveToThread(mp_workerThread);
 	QObject::connect(mp_workerThread, &QThread::finished, mp_workerObj, &QObject::deleteLater);
 	QObject::connect(mp_workerThread, SIGNAL(finished()), mp_workerThread, SLOT(deleteLater()));
+	// apply options that can only be set from the thread itself, started is emitted in the new thread
+	if (!options.name.isEmpty() || !options.cpuAffinity.isEmpty())
+	{
+		QObject::connect(mp_workerThread, &QThread::started, mp_workerObj, [options]() {
+			QLambdaThreadWorkerData::applyThreadOptions(options);
+		}, Qt::DirectConnection);
+	}
 	// start thread
-	mp_workerThread->start();
+	if (options.stackSize > 0)
+	{
+		mp_workerThread->setStackSize(options.stackSize);
+	}
+	mp_workerThread->start(options.priority);
+}
+
+void QLambdaThreadWorkerData::applyThreadOptions(const QLambdaThreadWorkerOptions &options)
+{
+#ifdef Q_OS_LINUX
+	if (!options.name.isEmpty())
+	{
+		// NOTE : linux limits names to 16 bytes including terminator
+		pthread_setname_np(pthread_self(), options.name.toUtf8().left(15).constData());
+	}
+	if (!options.cpuAffinity.isEmpty())
+	{
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		for (int i = 0; i < options.cpuAffinity.count(); i++)
+		{
+			CPU_SET(options.cpuAffinity.at(i), &cpuSet);
+		}
+		if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) != 0)
+		{
+			qWarning() << "QLambdaThreadWorker : Failed to set cpu affinity" << options.cpuAffinity;
+		}
+	}
+#else
+	if (!options.cpuAffinity.isEmpty())
+	{
+		qWarning() << "QLambdaThreadWorker : Cpu affinity not supported on this platform.";
+	}
+#endif
 }
 
 QLambdaThreadWorkerData::QLambdaThreadWorkerData(const QLambdaThreadWorkerData &other) : 
@@ -89,7 +769,6 @@ QLambdaThreadWorkerData::QLambdaThreadWorkerData(const QLambdaThreadWorkerData &
 	mp_workerThread(other.mp_workerThread),
 	mp_workerObj   (other.mp_workerObj   ),
 	m_strThreadId  (other.m_strThreadId  ),
-	m_intIdCounter (other.m_intIdCounter ),
 	m_requestedQuit(other.m_requestedQuit)
 {
 
@@ -105,22 +784,150 @@ QLambdaThreadWorkerData::~QLambdaThreadWorkerData()
 }
 
 bool QLambdaThreadWorkerData::execInThread(const std::function<void()> &threadFunc, const Qt::EventPriority &priority/* = Qt::NormalEventPriority*/)
+{
+	return this->execInThreadAtLevel(threadFunc, QLambdaThreadWorkerObjectData::levelForPriority(priority));
+}
+
+bool QLambdaThreadWorkerData::execInThreadAtLevel(const std::function<void()> &threadFunc, const int &intLevel)
 {
 	if (!mp_workerThread->isRunning() || m_requestedQuit)
 	{
 		return false;
 	}
-	// create event to exec in thread
-	QLambdaThreadWorkerDataEvent * p_Evt = new QLambdaThreadWorkerDataEvent;
-	p_Evt->m_eventFunc = threadFunc;
+	Q_ASSERT_X(intLevel >= 0 && intLevel < QLAMBDATHREADWORKER_PRIORITY_LEVELS, "QLambdaThreadWorker::execInThreadAtLevel", "Invalid level.");
 	// increment callback count
 	mp_workerObj->incrementCallbackCount();
-	// post event to thread
-	QCoreApplication::postEvent(mp_workerObj, p_Evt, priority);
+	// queue function to exec in thread (callback count decremented after the batch is executed)
+	mp_workerObj->post(threadFunc, qBound(0, intLevel, QLAMBDATHREADWORKER_PRIORITY_LEVELS - 1));
 	// success
 	return true;
 }
 
+bool QLambdaThreadWorkerData::execInThreadWithDeadline(const std::function<void()> &threadFunc, const qint64 &usBudget)
+{
+	if (!mp_workerThread->isRunning() || m_requestedQuit)
+	{
+		return false;
+	}
+	// increment callback count
+	mp_workerObj->incrementCallbackCount();
+	// queue function to exec in thread
+	mp_workerObj->postDeadline(threadFunc, usBudget);
+	// success
+	return true;
+}
+
+QList<QLambdaThreadWorkerLevelMetrics> QLambdaThreadWorkerData::getLevelMetrics() const
+{
+	return mp_workerObj->levelMetrics();
+}
+
+bool QLambdaThreadWorkerData::execNodeInThread(QEventMailboxNode * p_node)
+{
+	if (!mp_workerThread->isRunning() || m_requestedQuit)
+	{
+		return false;
+	}
+	// increment callback count
+	mp_workerObj->incrementCallbackCount();
+	// queue node to exec in thread
+	mp_workerObj->postNode(p_node);
+	// success
+	return true;
+}
+
+bool QLambdaThreadWorkerData::execBatchInThread(const QList<std::function<void()>> &listThreadFuncs, const int &intYieldEvery/* = 0*/)
+{
+	if (!mp_workerThread->isRunning() || m_requestedQuit)
+	{
+		return false;
+	}
+	if (listThreadFuncs.isEmpty())
+	{
+		return true;
+	}
+	QSharedPointer<QLambdaThreadWorkerBatch> p_batch(new QLambdaThreadWorkerBatch);
+	p_batch->listThreadFuncs = listThreadFuncs;
+	p_batch->intIndex        = 0;
+	p_batch->intYieldEvery   = intYieldEvery;
+	p_batch->intLevel        = QLAMBDATHREADWORKER_NORMAL_LEVEL;
+	// increment callback count once for the whole batch (continuations are not counted)
+	mp_workerObj->incrementCallbackCount();
+	// queue batch to exec in thread
+	QLambdaThreadWorkerObjectData * p_workerObj = mp_workerObj;
+	mp_workerObj->post([p_workerObj, p_batch]() {
+		QLambdaThreadWorkerData::execBatch(p_workerObj, p_batch);
+	}, p_batch->intLevel);
+	// success
+	return true;
+}
+
+void QLambdaThreadWorkerData::execBatch(QLambdaThreadWorkerObjectData * p_workerObj, QSharedPointer<QLambdaThreadWorkerBatch> p_batch)
+{
+	int count = 0;
+	while (p_batch->intIndex < p_batch->listThreadFuncs.count())
+	{
+		// let the event loop run (timers, loops, other events), then continue with the rest after the callbacks
+		// already queued, through the mailbox like any callback so it is seen by the level metrics and dropped
+		// by a DropPending quit
+		if (p_batch->intYieldEvery > 0 && count == p_batch->intYieldEvery)
+		{
+			// NOTE : pending like any callback (quit waits for it), but the batch is counted once in the stats
+			p_workerObj->incrementCallbackCount(false);
+			p_workerObj->post([p_workerObj, p_batch]() {
+				p_workerObj->skipExecutedCount();
+				QLambdaThreadWorkerData::execBatch(p_workerObj, p_batch);
+			}, p_batch->intLevel);
+			// NOTE : otherwise the drain in progress would pick up the continuation right away
+			p_workerObj->yieldToEventLoop();
+			return;
+		}
+		// release captures as soon as function is executed
+		std::function<void()> threadFunc = p_batch->listThreadFuncs[p_batch->intIndex];
+		p_batch->listThreadFuncs[p_batch->intIndex] = nullptr;
+		p_batch->intIndex++;
+		threadFunc();
+		count++;
+	}
+}
+
+QLambdaThreadWorkerStats QLambdaThreadWorkerData::getStats() const
+{
+	return mp_workerObj->stats();
+}
+
+void QLambdaThreadWorkerData::setTracingEnabled(const bool &enabled)
+{
+	mp_workerObj->trace()->setEnabled(enabled);
+}
+
+bool QLambdaThreadWorkerData::isTracingEnabled() const
+{
+	return mp_workerObj->trace()->isEnabled();
+}
+
+QLambdaThreadWorkerLatencyStats QLambdaThreadWorkerData::getQueueWaitStats() const
+{
+	return mp_workerObj->trace()->queueWaitStats();
+}
+
+QLambdaThreadWorkerLatencyStats QLambdaThreadWorkerData::getRunTimeStats() const
+{
+	return mp_workerObj->trace()->runTimeStats();
+}
+
+void QLambdaThreadWorkerData::resetTracing()
+{
+	mp_workerObj->trace()->reset();
+}
+
+QByteArray QLambdaThreadWorkerData::getChromeTraceEvents()
+{
+	QByteArray byteEvents;
+	mp_workerObj->trace()->appendChromeTraceEvents(byteEvents, this->getThreadId());
+	return byteEvents;
+}
+
 QString QLambdaThreadWorkerData::getThreadId()
 {
 	return m_strThreadId;
@@ -132,81 +939,42 @@ QThread * QLambdaThreadWorkerData::getThread()
 }
 
 int QLambdaThreadWorkerData::startLoopInThread(const std::function<void()> &threadLoopFunc, const quint32 &intMsSleep /*= 1000*/)
+{
+	// same as a periodic coarse timer, precise for zero interval so it runs on every event loop iteration
+	return this->startLoopInThread([threadLoopFunc](const QLambdaThreadWorkerLoopTick &) {
+		threadLoopFunc();
+	}, QLambdaThreadWorkerLoopOptions((quint64)intMsSleep * 1000, intMsSleep == 0 ? Qt::PreciseTimer : Qt::CoarseTimer));
+}
+
+int QLambdaThreadWorkerData::startLoopInThread(const std::function<void(const QLambdaThreadWorkerLoopTick&)> &threadLoopFunc, const QLambdaThreadWorkerLoopOptions &options)
 {
 	if (!mp_workerThread->isRunning() || m_requestedQuit)
 	{
 		return -1;
 	}
-	// get new custom id
-	m_intIdCounter++;
-	int newLoopId = m_intIdCounter;
-	// create function to start loop
-	// serialize map access by using event queue
-	this->execInThread([this, threadLoopFunc, intMsSleep, newLoopId]() {
-		// start the timer
-		int timerId = mp_workerObj->startTimer(intMsSleep);
-		// add timer id to map
-		m_mapIdtimerIds[newLoopId] = timerId;
-		// add function to map
-		mp_workerObj->m_mapFuncs[timerId] = threadLoopFunc;
-	}, Qt::HighEventPriority);
-	// return loop id (we still do not have timerId)
-	return newLoopId;
+	return mp_workerObj->startLoop(threadLoopFunc, options);
 }
 
 QDefer QLambdaThreadWorkerData::stopLoopInThread(const int &intLoopId)
 {
-	QDefer retDefer;
 	if (!mp_workerThread->isRunning() || m_requestedQuit)
 	{
+		QDefer retDefer;
 		retDefer.reject();
 		return retDefer;
 	}
-	// create function to stop loop, serialize map access by using event queue
-	this->execInThread([this, intLoopId, retDefer]() mutable {
-		if (!m_mapIdtimerIds.contains(intLoopId))
-		{
-			qWarning() << "QLambdaThreadWorker::stopLoopInThread : Invalid loop Id.";
-			retDefer.reject();
-			return;
-		}
-		// get real timer id of timer to stop
-		int timerId = m_mapIdtimerIds.take(intLoopId);
-		// remove function from map
-		mp_workerObj->m_mapFuncs.remove(timerId);
-		// stop timer
-		mp_workerObj->killTimer(timerId);
-		// success
-		retDefer.resolve();
-	}, Qt::HighEventPriority);
-	// return promise
-	return retDefer;
+	return mp_workerObj->stopLoop(intLoopId);
 }
 
 QDefer QLambdaThreadWorkerData::stopAllLoopsInThread()
 {
-	QDefer retDefer;
 	if (!mp_workerThread->isRunning() || m_requestedQuit)
 	{
+		QDefer retDefer;
 		retDefer.reject();
 		return retDefer;
 	}
-	// create function to stop loop, serialize map access by using event queue
-	this->execInThread([this, retDefer]() mutable {
-		while (m_mapIdtimerIds.count() > 0)
-		{
-			// get real timer id of timer to stop
-			int timerId = m_mapIdtimerIds.take(m_mapIdtimerIds.first());
-			// remove function from map
-			mp_workerObj->m_mapFuncs.remove(timerId);
-			// stop timer
-			mp_workerObj->killTimer(timerId);
-		}
-		// success
-		retDefer.resolve();
-	}, Qt::HighEventPriority);
-	// return promise
-	return retDefer;
+	return mp_workerObj->stopAllLoops();
 }
 
 bool QLambdaThreadWorkerData::moveQObjectToThread(QObject * pObject)
@@ -223,28 +991,31 @@ bool QLambdaThreadWorkerData::moveQObjectToThread(QObject * pObject)
 QDefer QLambdaThreadWorkerData::quitThread()
 {
 	QDefer retDefer;
+	this->quitThread(QLambdaThreadWorkerQuitOptions()).done([retDefer](quint32) mutable {
+		retDefer.resolve();
+	}, Qt::DirectConnection);
+	// return promise
+	return retDefer;
+}
+
+QDeferred<quint32> QLambdaThreadWorkerData::quitThread(const QLambdaThreadWorkerQuitOptions &options)
+{
+	QDeferred<quint32> retDefer;
 	if (mp_workerThread->isFinished() || m_requestedQuit)
 	{
-		retDefer.resolve();
+		retDefer.resolve(0);
 		return retDefer;
 	}
 	// subscribe to thread finished
-	QObject::connect(mp_workerThread, &QThread::finished, mp_workerObj, [retDefer]() mutable {
-		retDefer.resolve();
+	QLambdaThreadWorkerObjectData * p_workerObj = mp_workerObj;
+	QObject::connect(mp_workerThread, &QThread::finished, mp_workerObj, [retDefer, p_workerObj]() mutable {
+		retDefer.resolve(p_workerObj->droppedCount());
 	});
-	// stop all loops
-	auto defLoops = this->stopAllLoopsInThread();
 	// stop accepting new callbacks or loops
 	m_requestedQuit = true;
-	// wait for loops stopped
-	defLoops.done([this, retDefer]() {
-	// wait for remaining callbacks to be processed
-	QObject::connect(mp_workerObj, &QLambdaThreadWorkerObjectData::finishedProcessingCallbacks, mp_workerObj,
-		[this, retDefer]() mutable {
-			// actually quit thread
-			mp_workerThread->quit();
-		});
-	}, Qt::DirectConnection);
+	// the rest is done in the thread, high priority so it is not queued behind pending callbacks
+	mp_workerObj->requestQuit();
+	QCoreApplication::postEvent(mp_workerObj, new QLambdaThreadWorkerQuitEvent(options), Qt::HighEventPriority);
 	// return promise
 	return retDefer;
 }
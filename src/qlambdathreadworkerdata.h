@@ -6,19 +6,215 @@
 #include <QEvent>
 #include <QSharedData>
 #include <QMap>
+#include <QList>
+#include <QSharedPointer>
+#include <QAtomicInteger>
+#include <QAtomicInt>
+#include <QVector>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QDeferred>
 #include <functional>
 
-#define QLAMBDATHREADWORKERDATA_EVENT_TYPE (QEvent::Type)(QEvent::User + 666)
+#include "qeventmailbox.hpp"
+#include "qlambdathreadworkertrace.h"
+
+// wakeup event of the mailbox used to queue normal priority callbacks
+#define QLAMBDATHREADWORKERDATA_MAILBOX_EVENT_TYPE (QEvent::Type)(QEvent::User + 667)
+// start quitting, not counted as a callback
+#define QLAMBDATHREADWORKERDATA_QUIT_EVENT_TYPE (QEvent::Type)(QEvent::User + 668)
+
+// priority levels of callbacks, 0 is the lowest, each level is a FIFO queue
+#define QLAMBDATHREADWORKER_PRIORITY_LEVELS 8
+// level of callbacks queued with Qt::NormalEventPriority (High and Low are 3 levels above and below)
+#define QLAMBDATHREADWORKER_NORMAL_LEVEL    3
+// pseudo levels of the metrics, callbacks with a deadline and internal control callbacks
+#define QLAMBDATHREADWORKER_DEADLINE_LEVEL  (QLAMBDATHREADWORKER_PRIORITY_LEVELS)
+#define QLAMBDATHREADWORKER_CONTROL_LEVEL   (QLAMBDATHREADWORKER_PRIORITY_LEVELS + 1)
+
+// QLAMBDATHREADWORKEROPTIONS -----------------------------------------------
+
+// options of the thread created by a worker
+struct QLambdaThreadWorkerOptions
+{
+	explicit QLambdaThreadWorkerOptions(const QString &name = QString(), 
+		                                const QThread::Priority &priority = QThread::InheritPriority,
+		                                const uint &stackSize = 0,
+		                                const QList<int> &cpuAffinity = QList<int>());
+
+	// thread name, shown by debuggers, top and getThreadId (linux limits it to 15 characters)
+	QString           name;
+	QThread::Priority priority;
+	// stack size in bytes, 0 for the operating system default
+	uint              stackSize;
+	// cpus the thread is allowed to run on, empty for no restriction (only supported on linux)
+	QList<int>        cpuAffinity;
+};
+
+// QLAMBDATHREADWORKERQUITOPTIONS -------------------------------------------
+
+// how a worker quits
+struct QLambdaThreadWorkerQuitOptions
+{
+	enum Policy
+	{
+		// execute every pending callback while loops keep running, then stop loops and quit
+		DrainAll,
+		// stop loops, then execute every pending callback and quit
+		CancelLoopsThenDrain,
+		// stop loops and quit after the callback currently executing, pending callbacks are dropped
+		DropPending
+	};
+
+	explicit QLambdaThreadWorkerQuitOptions(const Policy &policy = CancelLoopsThenDrain, const qint64 &msDeadline = -1);
+
+	Policy policy;
+	// milliseconds after which pending callbacks are dropped anyway, -1 to wait forever
+	// NOTE : checked between callbacks, a callback that never returns still blocks the quit
+	qint64 msDeadline;
+};
+
+// QLAMBDATHREADWORKERSTATS -------------------------------------------------
+
+// snapshot of the statistics of a worker, each field is read atomically but not the struct as a whole
+struct QLambdaThreadWorkerStats
+{
+	// callbacks queued since the worker was created
+	quint64 submitted;
+	// callbacks executed since the worker was created
+	quint64 executed;
+	// callbacks currently waiting to be executed
+	quint32 depth;
+	// maximum number of callbacks ever waiting at the same time
+	quint32 maxDepth;
+	// cumulative time spent executing callbacks and loops in nanoseconds
+	qint64  busyNs;
+	// callbacks with a deadline that started after it
+	quint64 deadlineMisses;
+};
+
+// queue metrics of a priority level
+struct QLambdaThreadWorkerLevelMetrics
+{
+	// 0 to QLAMBDATHREADWORKER_PRIORITY_LEVELS - 1, QLAMBDATHREADWORKER_DEADLINE_LEVEL or QLAMBDATHREADWORKER_CONTROL_LEVEL
+	int level;
+	// callbacks currently waiting to be executed
+	int depth;
+	// maximum number of callbacks ever waiting at the same time
+	int maxDepth;
+};
+
+// QLAMBDATHREADWORKERLOOPOPTIONS -------------------------------------------
+
+// scheduling options of a loop started with startLoopInThread
+struct QLambdaThreadWorkerLoopOptions
+{
+	enum Schedule
+	{
+		// ticks are due at start + n * period, execution time does not delay the next tick
+		FixedRate,
+		// next tick is due one period after the previous tick finished
+		FixedDelay
+	};
+	enum MissedTicks
+	{
+		// ticks missed by a late tick are dropped, loop continues on the next due tick
+		Skip,
+		// ticks missed by a late tick are executed back to back until the loop catches up
+		Burst,
+		// ticks missed by a late tick are merged into a single tick executed right away
+		Coalesce
+	};
+
+	explicit QLambdaThreadWorkerLoopOptions(const quint64 &periodUs = 1000000, 
+		                                    const Qt::TimerType &timerType = Qt::PreciseTimer, 
+		                                    const Schedule &schedule = FixedRate, 
+		                                    const MissedTicks &missedTicks = Skip);
+
+	// period in microseconds
+	quint64       periodUs;
+	// NOTE : periods of less than a millisecond, or the fraction of millisecond of PreciseTimer loops,
+	//        are waited by letting the event loop spin, which keeps the thread busy
+	Qt::TimerType timerType;
+	Schedule      schedule;
+	// only for FixedRate loops, FixedDelay loops never miss ticks
+	MissedTicks   missedTicks;
+};
+
+// timing of a loop tick, passed to the loop function
+struct QLambdaThreadWorkerLoopTick
+{
+	// number of executed ticks before this one
+	quint64 tick;
+	// times in nanoseconds since loop started
+	qint64  scheduledNs;
+	qint64  startNs;
+	// startNs - scheduledNs
+	qint64  latenessNs;
+	// ticks skipped or coalesced right before this tick
+	quint64 missedTicks;
+	// ticks skipped or coalesced since loop started
+	quint64 totalMissedTicks;
+	// execution time of previous tick in nanoseconds
+	qint64  lastRunNs;
+	// ticks whose execution took longer than the period
+	quint64 overruns;
+};
+
+// QLAMBDATHREADWORKERTIMERQUEUE --------------------------------------------
+
+// loop scheduled in the timer queue of a worker
+struct QLambdaThreadWorkerLoop
+{
+	int                                                      loopId;
+	std::function<void(const QLambdaThreadWorkerLoopTick &)> loopFunc;
+	QLambdaThreadWorkerLoopOptions                           options;
+	// start time and next deadline in nanoseconds of the worker clock
+	qint64                                                   startNs;
+	qint64                                                   nextNs;
+	// ticks missed while scheduling the next tick
+	quint64                                                  pendingMissed;
+	QLambdaThreadWorkerLoopTick                              tick;
+	// position in the timer queue, -1 while executing or after stopped
+	int                                                      heapIndex;
+	bool                                                     stopped;
+	// stop requests received while executing, resolved after the tick
+	QList<QDefer>                                            listStopDefers;
+};
+
+// binary min-heap of loops ordered by next deadline, push, pop and remove are O(log n)
+// NOTE : not thread safe, protected by the mutex of the worker object owning it
+class QLambdaThreadWorkerTimerQueue
+{
+public:
+	void   push(const QSharedPointer<QLambdaThreadWorkerLoop> &p_loop);
+
+	QSharedPointer<QLambdaThreadWorkerLoop> pop();
+
+	void   remove(const QSharedPointer<QLambdaThreadWorkerLoop> &p_loop);
+
+	// null if empty
+	QSharedPointer<QLambdaThreadWorkerLoop> top() const;
+
+	int    count() const;
+
+private:
+	void siftUp(int index);
+	void siftDown(int index);
+	void swap(const int &indexA, const int &indexB);
+
+	QVector<QSharedPointer<QLambdaThreadWorkerLoop>> m_heap;
+};
 
 // QDEFTHREADWORKERDATAEVENT -------------------------------------------------
 
-class QLambdaThreadWorkerDataEvent : public QEvent
+class QLambdaThreadWorkerQuitEvent : public QEvent
 {
 public:
-	explicit QLambdaThreadWorkerDataEvent();
+	explicit QLambdaThreadWorkerQuitEvent(const QLambdaThreadWorkerQuitOptions &options);
 
-	std::function<void()> m_eventFunc;
+	QLambdaThreadWorkerQuitOptions m_options;
 
 };
 
@@ -32,9 +228,44 @@ public:
 
 	bool event(QEvent* ev);
 
-	quint32 incrementCallbackCount();
+	// isCounted is false for internal continuations, which are not counted in the submitted and executed stats
+	quint32 incrementCallbackCount(const bool &isCounted = true);
+
+	quint32 decrementCallbackCount(const quint32 &count = 1);
+
+	// called by an uncounted callback while executing, so it is not counted as executed either (worker thread)
+	void    skipExecutedCount();
+
+	// stop the mailbox drain after the executing callback, so the event loop runs before the rest (worker thread)
+	void    yieldToEventLoop();
 
-	quint32 decrementCallbackCount();
+	QLambdaThreadWorkerStats stats() const;
+
+	// start loop, returns loop id (thread safe)
+	int    startLoop(const std::function<void(const QLambdaThreadWorkerLoopTick &)> &threadLoopFunc, const QLambdaThreadWorkerLoopOptions &options);
+	// stop loop, resolved once loop is not executing anymore (thread safe)
+	QDefer stopLoop(const int &intLoopId);
+	QDefer stopAllLoops();
+
+	// callbacks dropped when quitting
+	quint32 droppedCount() const;
+	// interrupt draining so the quit event is processed after the callback currently executing (thread safe)
+	void    requestQuit();
+
+	// queue function to be executed in the thread of this object
+	template<typename F>
+	void post(F &&func, const int &intLevel = QLAMBDATHREADWORKER_NORMAL_LEVEL);
+	// queue node to be executed in the thread of this object (takes ownership)
+	void postNode(QEventMailboxNode * p_node, const int &intLevel = QLAMBDATHREADWORKER_NORMAL_LEVEL);
+	// queue function to be executed before any priority level, earliest deadline first
+	void postDeadline(const std::function<void()> &func, const qint64 &usBudget);
+
+	QList<QLambdaThreadWorkerLevelMetrics> levelMetrics() const;
+
+	// level of a Qt event priority
+	static int levelForPriority(const Qt::EventPriority &priority);
+
+	QLambdaThreadWorkerTrace * trace();
 
 signals:
 	void finishedProcessingCallbacks();
@@ -43,15 +274,94 @@ protected:
 	void timerEvent(QTimerEvent *event);
 
 private:
-	// map of 'loop' timer functions is stored here but administered in QLambdaThreadWorkerData
-	// map is <timerIds, timerFuncs>
-	QMap<int, std::function<void()>> m_mapFuncs;
-	// make friend, so it can admin the map
-	friend class QLambdaThreadWorkerData;
+	// [NOTE] Quit methods must be called in the thread of this object
+	void beginQuit(const QLambdaThreadWorkerQuitOptions &options);
+	// quit thread if nothing left to drain or deadline passed
+	void checkQuit();
+	bool isPastQuitDeadline() const;
+	// execute queued callbacks, one by one if quitting with deadline
+	int  drainMailbox();
+	QAtomicInt                                         m_quitRequested;
+	bool                                               m_quitting;
+	bool                                               m_quitDone;
+	QLambdaThreadWorkerQuitOptions                     m_quitOptions;
+	// deadline in nanoseconds of the worker clock, -1 for none
+	qint64                                             m_quitDeadlineNs;
+	int                                                m_quitTimerId;
+	QAtomicInteger<quint32>                            m_dropped;
+	// [NOTE] Timer queue methods must be called in the thread of this object
+	void armTimerQueue();
+	void serviceTimerQueue();
+	void tickLoop(QLambdaThreadWorkerLoop * p_loop);
+	// arm timer queue from any thread
+	void requestArmTimerQueue();
+	// loops, protected by m_loopMutex
+	QMutex                                             m_loopMutex;
+	QHash<int, QSharedPointer<QLambdaThreadWorkerLoop>> m_hashLoops;
+	QLambdaThreadWorkerTimerQueue                      m_timerQueue;
+	QAtomicInt                                         m_loopIdCounter;
+	// clock all loop deadlines refer to
+	QElapsedTimer                                      m_clock;
+	// single timer armed for the earliest deadline, only accessed in the thread of this object
+	int                                                m_timerId;
+	// an arm request is already queued
+	QAtomicInt                                         m_armRequested;
+	// callbacks with deadline, min-heap by deadline protected by m_deadlineMutex
+	struct DeadlineTask
+	{
+		qint64                deadlineNs;
+		// posting order, FIFO among equal deadlines
+		quint64               sequence;
+		std::function<void()> func;
+	};
+	static bool isLaterDeadline(const DeadlineTask &taskA, const DeadlineTask &taskB);
+	// execute callback with earliest deadline, one is queued for each deadline callback
+	void execEarliestDeadline();
+	QMutex                                             m_deadlineMutex;
+	QVector<DeadlineTask>                              m_deadlineHeap;
+	quint64                                            m_deadlineSequence;
+	QAtomicInteger<quint64>                            m_deadlineMisses;
+	// mailbox lane of a level, lanes are sorted highest first
+	static int laneForLevel(const int &intLevel);
+	static QList<int> lanePriorities();
 	// count callbacks
-	quint32 m_callbacksToExec;
-	// mutex to protect count
-	QMutex m_mutex;
+	QAtomicInteger<quint32> m_callbacksToExec;
+	// statistics
+	QAtomicInteger<quint64> m_submitted;
+	QAtomicInteger<quint64> m_executed;
+	// uncounted callbacks executed since the last decrement (worker thread)
+	quint32                 m_uncountedExecuted;
+	QAtomicInteger<quint32> m_maxDepth;
+	QAtomicInteger<qint64>  m_busyNs;
+	// NOTE : declared before the mailbox, traced tasks dropped by the mailbox refer to it
+	QLambdaThreadWorkerTrace m_trace;
+	// lock-free queue of callbacks
+	QEventMailbox m_mailbox;
+};
+
+template<typename F>
+void QLambdaThreadWorkerObjectData::post(F &&func, const int &intLevel/* = QLAMBDATHREADWORKER_NORMAL_LEVEL*/)
+{
+	// traced tasks are wrapped by postNode
+	if (m_trace.isEnabled())
+	{
+		this->postNode(new QEventMailboxTask<typename std::decay<F>::type>(std::forward<F>(func)), intLevel);
+		return;
+	}
+	m_mailbox.post(std::forward<F>(func), QLambdaThreadWorkerObjectData::laneForLevel(intLevel));
+}
+
+// QLAMBDATHREADWORKERBATCH -------------------------------------------------
+
+// functions submitted together with execBatchInThread
+struct QLambdaThreadWorkerBatch
+{
+	QList<std::function<void()>> listThreadFuncs;
+	// next function to execute
+	int                          intIndex;
+	// functions to execute before queueing the rest behind the callbacks already queued (0 = all)
+	int                          intYieldEvery;
+	int                          intLevel;
 };
 
 // QDEFTHREADWORKERDATA -----------------------------------------------------
@@ -59,18 +369,47 @@ private:
 class QLambdaThreadWorkerData : public QSharedData
 {
 public:
-	QLambdaThreadWorkerData();
+	QLambdaThreadWorkerData(const QLambdaThreadWorkerOptions &options = QLambdaThreadWorkerOptions());
 	QLambdaThreadWorkerData(const QLambdaThreadWorkerData &other);
 	~QLambdaThreadWorkerData();
 
 	bool     execInThread(const std::function<void()> &threadFunc, const Qt::EventPriority &priority = Qt::NormalEventPriority);
 
+	bool     execInThreadAtLevel(const std::function<void()> &threadFunc, const int &intLevel);
+
+	bool     execInThreadWithDeadline(const std::function<void()> &threadFunc, const qint64 &usBudget);
+
+	QList<QLambdaThreadWorkerLevelMetrics> getLevelMetrics() const;
+
+	// queue node to be executed in thread, false if thread not running (caller keeps ownership then)
+	bool     execNodeInThread(QEventMailboxNode * p_node);
+
+	// queue all functions as a single unit, executed back to back yielding to the event loop every intYieldEvery
+	bool     execBatchInThread(const QList<std::function<void()>> &listThreadFuncs, const int &intYieldEvery = 0);
+
+	QLambdaThreadWorkerStats getStats() const;
+
+	void     setTracingEnabled(const bool &enabled);
+
+	bool     isTracingEnabled() const;
+
+	QLambdaThreadWorkerLatencyStats getQueueWaitStats() const;
+
+	QLambdaThreadWorkerLatencyStats getRunTimeStats() const;
+
+	void     resetTracing();
+
+	// comma separated chrome trace events of the traced tasks
+	QByteArray getChromeTraceEvents();
+
 	QString  getThreadId();
 
 	QThread* getThread();
 
 	int      startLoopInThread(const std::function<void()> &threadLoopFunc, const quint32 &uiMsSleep = 1000);
 
+	int      startLoopInThread(const std::function<void(const QLambdaThreadWorkerLoopTick &)> &threadLoopFunc, const QLambdaThreadWorkerLoopOptions &options);
+
 	QDefer   stopLoopInThread(const int &intLoopId);
 
 	QDefer   stopAllLoopsInThread();
@@ -78,17 +417,19 @@ public:
 	bool     moveQObjectToThread(QObject * pObject);
 
 	QDefer   quitThread();
+
+	QDeferred<quint32> quitThread(const QLambdaThreadWorkerQuitOptions &options);
+
+	// set name and affinity of current thread
+	static void applyThreadOptions(const QLambdaThreadWorkerOptions &options);
 	
 private:
 	QThread                       * mp_workerThread;
 	QLambdaThreadWorkerObjectData * mp_workerObj;
 	QString                         m_strThreadId;
-	// map of custom id, to timer id 
-	// necessary because timers cannot be started/stopped on a different thread,
-	// therefore we cannot get a timer id to return inmediatly
-	QMap<int, int> m_mapIdtimerIds;
-	int            m_intIdCounter;
-	bool           m_requestedQuit;
+	bool                            m_requestedQuit;
+	// execute functions of a batch (runs in worker thread)
+	static void execBatch(QLambdaThreadWorkerObjectData * p_workerObj, QSharedPointer<QLambdaThreadWorkerBatch> p_batch);
 };
 
 #endif // QQLAMBDATHREADWORKERDATA_H
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "qlambdathreadworkertrace.h"
+#include <QElapsedTimer>
+#include <QtAlgorithms>
+#include <cmath>
+#include <limits>
+
+// QLAMBDATHREADWORKERHISTOGRAM ---------------------------------------------
+
+QLambdaThreadWorkerHistogram::QLambdaThreadWorkerHistogram()
+{
+	this->reset();
+}
+
+void QLambdaThreadWorkerHistogram::record(const qint64 &valueNs)
+{
+	qint64 value = qMax(valueNs, (qint64)0);
+	m_buckets[QLambdaThreadWorkerHistogram::bucketIndex(value)].fetchAndAddRelaxed(1);
+	m_count.fetchAndAddRelaxed(1);
+	m_sumNs.fetchAndAddRelaxed((quint64)value);
+	qint64 currMin = m_minNs.loadAcquire();
+	while (value < currMin && !m_minNs.testAndSetRelaxed(currMin, value, currMin))
+	{
+		// retry with updated minimum
+	}
+	qint64 currMax = m_maxNs.loadAcquire();
+	while (value > currMax && !m_maxNs.testAndSetRelaxed(currMax, value, currMax))
+	{
+		// retry with updated maximum
+	}
+}
+
+void QLambdaThreadWorkerHistogram::reset()
+{
+	for (int i = 0; i < QLAMBDATHREADWORKERHISTOGRAM_BUCKETS; i++)
+	{
+		m_buckets[i].storeRelease(0);
+	}
+	m_count.storeRelease(0);
+	m_sumNs.storeRelease(0);
+	m_minNs.storeRelease(std::numeric_limits<qint64>::max());
+	m_maxNs.storeRelease(0);
+}
+
+quint64 QLambdaThreadWorkerHistogram::count() const
+{
+	return m_count.loadAcquire();
+}
+
+qint64 QLambdaThreadWorkerHistogram::valueAtPercentile(const double &percentile) const
+{
+	// NOTE : buckets are read one by one while other threads may be recording, so use their own total
+	quint64 total = 0;
+	for (int i = 0; i < QLAMBDATHREADWORKERHISTOGRAM_BUCKETS; i++)
+	{
+		total += m_buckets[i].loadAcquire();
+	}
+	if (total == 0)
+	{
+		return 0;
+	}
+	quint64 target = (quint64)std::ceil(qBound(0.0, percentile, 100.0) / 100.0 * (double)total);
+	target = qMax(target, (quint64)1);
+	quint64 accumulated = 0;
+	for (int i = 0; i < QLAMBDATHREADWORKERHISTOGRAM_BUCKETS; i++)
+	{
+		accumulated += m_buckets[i].loadAcquire();
+		if (accumulated >= target)
+		{
+			return qMin(QLambdaThreadWorkerHistogram::bucketUpperBound(i), m_maxNs.loadAcquire());
+		}
+	}
+	return m_maxNs.loadAcquire();
+}
+
+QLambdaThreadWorkerLatencyStats QLambdaThreadWorkerHistogram::stats() const
+{
+	QLambdaThreadWorkerLatencyStats stats;
+	stats.count  = m_count.loadAcquire();
+	stats.minNs  = stats.count > 0 ? m_minNs.loadAcquire() : 0;
+	stats.maxNs  = m_maxNs.loadAcquire();
+	stats.meanNs = stats.count > 0 ? (double)m_sumNs.loadAcquire() / (double)stats.count : 0.0;
+	stats.p50Ns  = this->valueAtPercentile(50.0);
+	stats.p90Ns  = this->valueAtPercentile(90.0);
+	stats.p99Ns  = this->valueAtPercentile(99.0);
+	stats.p999Ns = this->valueAtPercentile(99.9);
+	return stats;
+}
+
+int QLambdaThreadWorkerHistogram::bucketIndex(const qint64 &valueNs)
+{
+	const int subCount = 1 << QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS;
+	if (valueNs < subCount)
+	{
+		return (int)qMax(valueNs, (qint64)0);
+	}
+	if (valueNs >= ((qint64)1 << QLAMBDATHREADWORKERHISTOGRAM_MAX_BITS))
+	{
+		return QLAMBDATHREADWORKERHISTOGRAM_BUCKETS - 1;
+	}
+	// position of the most significant bit, then the next SUB_BITS bits select the sub-bucket
+	int msb   = 63 - (int)qCountLeadingZeroBits((quint64)valueNs);
+	int shift = msb - QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS;
+	int sub   = (int)((valueNs >> shift) & (subCount - 1));
+	return ((msb - QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS + 1) << QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS) + sub;
+}
+
+qint64 QLambdaThreadWorkerHistogram::bucketUpperBound(const int &index)
+{
+	const int subCount = 1 << QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS;
+	if (index < subCount)
+	{
+		return index;
+	}
+	int msb   = (index >> QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS) + QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS - 1;
+	int shift = msb - QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS;
+	int sub   = index & (subCount - 1);
+	return (((qint64)(subCount + sub)) << shift) + ((qint64)1 << shift) - 1;
+}
+
+// QLAMBDATHREADWORKERTRACEBUFFER -------------------------------------------
+
+QLambdaThreadWorkerTraceBuffer::QLambdaThreadWorkerTraceBuffer(const int &intCapacity) :
+	m_intCapacity(qMax(1, intCapacity)),
+	m_written(0)
+{
+	mp_slots = new Slot[m_intCapacity];
+	for (int i = 0; i < m_intCapacity; i++)
+	{
+		mp_slots[i].m_sequence.storeRelease(0);
+	}
+}
+
+QLambdaThreadWorkerTraceBuffer::~QLambdaThreadWorkerTraceBuffer()
+{
+	delete[] mp_slots;
+}
+
+void QLambdaThreadWorkerTraceBuffer::append(const QLambdaThreadWorkerTraceRecord &record)
+{
+	quint64 written = m_written.loadAcquire();
+	Slot &slot = mp_slots[written % (quint64)m_intCapacity];
+	quint64 sequence = slot.m_sequence.loadAcquire();
+	slot.m_sequence.storeRelease(sequence + 1);
+	slot.m_enqueueNs.storeRelease(record.enqueueNs);
+	slot.m_startNs.storeRelease(record.startNs);
+	slot.m_endNs.storeRelease(record.endNs);
+	slot.m_sequence.storeRelease(sequence + 2);
+	m_written.storeRelease(written + 1);
+}
+
+QList<QLambdaThreadWorkerTraceRecord> QLambdaThreadWorkerTraceBuffer::records() const
+{
+	QList<QLambdaThreadWorkerTraceRecord> listRecords;
+	quint64 written = m_written.loadAcquire();
+	quint64 first   = written > (quint64)m_intCapacity ? written - (quint64)m_intCapacity : 0;
+	for (quint64 i = first; i < written; i++)
+	{
+		const Slot &slot = mp_slots[i % (quint64)m_intCapacity];
+		quint64 sequence = slot.m_sequence.loadAcquire();
+		QLambdaThreadWorkerTraceRecord record;
+		record.enqueueNs = slot.m_enqueueNs.loadAcquire();
+		record.startNs   = slot.m_startNs.loadAcquire();
+		record.endNs     = slot.m_endNs.loadAcquire();
+		// skip slot being written or already overwritten
+		if ((sequence & 1) != 0 || slot.m_sequence.loadAcquire() != sequence)
+		{
+			continue;
+		}
+		listRecords.append(record);
+	}
+	return listRecords;
+}
+
+// QLAMBDATHREADWORKERTRACE -------------------------------------------------
+
+QLambdaThreadWorkerTrace::QLambdaThreadWorkerTrace() :
+	m_enabled(0),
+	mp_buffer(nullptr)
+{
+	static QAtomicInt traceIdCounter;
+	m_intTraceId = traceIdCounter.fetchAndAddRelaxed(1) + 1;
+}
+
+QLambdaThreadWorkerTrace::~QLambdaThreadWorkerTrace()
+{
+	delete mp_buffer.loadAcquire();
+}
+
+void QLambdaThreadWorkerTrace::setEnabled(const bool &enabled)
+{
+	if (enabled && !mp_buffer.loadAcquire())
+	{
+		QMutexLocker locker(&m_bufferMutex);
+		if (!mp_buffer.loadAcquire())
+		{
+			mp_buffer.storeRelease(new QLambdaThreadWorkerTraceBuffer(QLAMBDATHREADWORKERTRACE_CAPACITY));
+		}
+	}
+	m_enabled.storeRelease(enabled ? 1 : 0);
+}
+
+bool QLambdaThreadWorkerTrace::isEnabled() const
+{
+	return m_enabled.loadAcquire() != 0;
+}
+
+void QLambdaThreadWorkerTrace::record(const qint64 &enqueueNs, const qint64 &startNs, const qint64 &endNs)
+{
+	m_queueWait.record(startNs - enqueueNs);
+	m_runTime.record(endNs - startNs);
+	QLambdaThreadWorkerTraceBuffer * p_buffer = mp_buffer.loadAcquire();
+	if (p_buffer)
+	{
+		QLambdaThreadWorkerTraceRecord traceRecord;
+		traceRecord.enqueueNs = enqueueNs;
+		traceRecord.startNs   = startNs;
+		traceRecord.endNs     = endNs;
+		p_buffer->append(traceRecord);
+	}
+}
+
+void QLambdaThreadWorkerTrace::reset()
+{
+	m_queueWait.reset();
+	m_runTime.reset();
+}
+
+QLambdaThreadWorkerLatencyStats QLambdaThreadWorkerTrace::queueWaitStats() const
+{
+	return m_queueWait.stats();
+}
+
+QLambdaThreadWorkerLatencyStats QLambdaThreadWorkerTrace::runTimeStats() const
+{
+	return m_runTime.stats();
+}
+
+void QLambdaThreadWorkerTrace::appendChromeTraceEvents(QByteArray &byteEvents, const QString &strName) const
+{
+	QLambdaThreadWorkerTraceBuffer * p_buffer = mp_buffer.loadAcquire();
+	if (!p_buffer)
+	{
+		return;
+	}
+	QByteArray byteTid = QByteArray::number(m_intTraceId);
+	QByteArray byteName = strName.toUtf8().replace('\\', "\\\\").replace('"', "\\\"");
+	auto toUs = [](const qint64 &ns) {
+		return QByteArray::number((double)ns / 1000.0, 'f', 3);
+	};
+	if (!byteEvents.isEmpty())
+	{
+		byteEvents += ",\n";
+	}
+	byteEvents += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + byteTid + ",\"args\":{\"name\":\"" + byteName + "\"}}";
+	QList<QLambdaThreadWorkerTraceRecord> listRecords = p_buffer->records();
+	for (int i = 0; i < listRecords.count(); i++)
+	{
+		const QLambdaThreadWorkerTraceRecord &record = listRecords.at(i);
+		// NOTE : queue waits of different tasks overlap, so they are async events (own track per id),
+		//        runs never overlap within a worker so they are complete events in the thread track
+		QByteArray byteId = byteTid + "." + QByteArray::number(i);
+		byteEvents += ",\n{\"name\":\"queued\",\"cat\":\"queue\",\"ph\":\"b\",\"id\":\"" + byteId + "\",\"pid\":1,\"tid\":" + byteTid + ",\"ts\":" + toUs(record.enqueueNs) + "}";
+		byteEvents += ",\n{\"name\":\"queued\",\"cat\":\"queue\",\"ph\":\"e\",\"id\":\"" + byteId + "\",\"pid\":1,\"tid\":" + byteTid + ",\"ts\":" + toUs(record.startNs) + "}";
+		byteEvents += ",\n{\"name\":\"task\",\"cat\":\"run\",\"ph\":\"X\",\"pid\":1,\"tid\":" + byteTid + ",\"ts\":" + toUs(record.startNs) + 
+		              ",\"dur\":" + toUs(record.endNs - record.startNs) + ",\"args\":{\"waitUs\":" + toUs(record.startNs - record.enqueueNs) + "}}";
+	}
+}
+
+qint64 QLambdaThreadWorkerTrace::nowNs()
+{
+	static QElapsedTimer clock = []() {
+		QElapsedTimer timer;
+		timer.start();
+		return timer;
+	}();
+	return clock.nsecsElapsed();
+}
+
+// QLAMBDATHREADWORKERTRACEDTASK --------------------------------------------
+
+QLambdaThreadWorkerTracedTask::QLambdaThreadWorkerTracedTask(QEventMailboxNode * p_node, QLambdaThreadWorkerTrace * p_trace) :
+	mp_node(p_node),
+	mp_trace(p_trace),
+	m_enqueueNs(QLambdaThreadWorkerTrace::nowNs())
+{
+
+}
+
+QLambdaThreadWorkerTracedTask::~QLambdaThreadWorkerTracedTask()
+{
+	delete mp_node;
+}
+
+void QLambdaThreadWorkerTracedTask::exec()
+{
+	qint64 startNs = QLambdaThreadWorkerTrace::nowNs();
+	mp_node->exec();
+	mp_trace->record(m_enqueueNs, startNs, QLambdaThreadWorkerTrace::nowNs());
+}
@@ -0,0 +1,158 @@
+#ifndef QLAMBDATHREADWORKERTRACE_H
+#define QLAMBDATHREADWORKERTRACE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QAtomicInteger>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+
+#include "qeventmailbox.hpp"
+
+// sub-buckets per power of two of the histograms (as bits), recorded values are within 1/16 of the real ones
+#define QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS 4
+// values up to 2^QLAMBDATHREADWORKERHISTOGRAM_MAX_BITS nanoseconds (~73 minutes), larger ones go to the last bucket
+#define QLAMBDATHREADWORKERHISTOGRAM_MAX_BITS 42
+#define QLAMBDATHREADWORKERHISTOGRAM_BUCKETS  ((QLAMBDATHREADWORKERHISTOGRAM_MAX_BITS - QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS + 1) << QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS)
+// most recent tasks kept for the chrome trace export
+#define QLAMBDATHREADWORKERTRACE_CAPACITY     4096
+
+// summary of a latency histogram, percentiles are the upper bound of the bucket they fall in
+struct QLambdaThreadWorkerLatencyStats
+{
+	quint64 count;
+	qint64  minNs;
+	qint64  maxNs;
+	double  meanNs;
+	qint64  p50Ns;
+	qint64  p90Ns;
+	qint64  p99Ns;
+	qint64  p999Ns;
+};
+
+// QLAMBDATHREADWORKERHISTOGRAM ---------------------------------------------
+
+// lock-free log-linear histogram of nanosecond values (HDR style), fixed memory and O(1) record
+// NOTE : buckets are exact below 2^QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS, then each power of two is split
+//        in 2^QLAMBDATHREADWORKERHISTOGRAM_SUB_BITS equal sub-buckets
+class QLambdaThreadWorkerHistogram
+{
+public:
+	QLambdaThreadWorkerHistogram();
+
+	// any thread
+	void    record(const qint64 &valueNs);
+	void    reset();
+
+	quint64 count() const;
+	// value below which the given percentage (0 to 100) of recorded values fall
+	qint64  valueAtPercentile(const double &percentile) const;
+	QLambdaThreadWorkerLatencyStats stats() const;
+
+	static int    bucketIndex(const qint64 &valueNs);
+	static qint64 bucketUpperBound(const int &index);
+
+private:
+	Q_DISABLE_COPY(QLambdaThreadWorkerHistogram)
+	QAtomicInteger<quint64> m_buckets[QLAMBDATHREADWORKERHISTOGRAM_BUCKETS];
+	QAtomicInteger<quint64> m_count;
+	QAtomicInteger<quint64> m_sumNs;
+	QAtomicInteger<qint64>  m_minNs;
+	QAtomicInteger<qint64>  m_maxNs;
+};
+
+// QLAMBDATHREADWORKERTRACEBUFFER -------------------------------------------
+
+// timing of an executed task, nanoseconds of QLambdaThreadWorkerTrace::nowNs
+struct QLambdaThreadWorkerTraceRecord
+{
+	qint64 enqueueNs;
+	qint64 startNs;
+	qint64 endNs;
+};
+
+// ring of the most recent records, single writer (worker thread), readers in any thread
+// NOTE : each slot is a seqlock, readers skip slots being overwritten while they read them
+class QLambdaThreadWorkerTraceBuffer
+{
+public:
+	explicit QLambdaThreadWorkerTraceBuffer(const int &intCapacity);
+	~QLambdaThreadWorkerTraceBuffer();
+
+	void append(const QLambdaThreadWorkerTraceRecord &record);
+	// oldest first
+	QList<QLambdaThreadWorkerTraceRecord> records() const;
+
+private:
+	Q_DISABLE_COPY(QLambdaThreadWorkerTraceBuffer)
+	struct Slot
+	{
+		// odd while being written
+		QAtomicInteger<quint64> m_sequence;
+		QAtomicInteger<qint64>  m_enqueueNs;
+		QAtomicInteger<qint64>  m_startNs;
+		QAtomicInteger<qint64>  m_endNs;
+	};
+	Slot                  * mp_slots;
+	int                     m_intCapacity;
+	QAtomicInteger<quint64> m_written;
+};
+
+// QLAMBDATHREADWORKERTRACE -------------------------------------------------
+
+// optional tracing of the tasks of a worker, queue wait (enqueue to start) and run time (start to end)
+class QLambdaThreadWorkerTrace
+{
+public:
+	QLambdaThreadWorkerTrace();
+	~QLambdaThreadWorkerTrace();
+
+	// NOTE : tasks queued while disabled are not traced even if executed after enabling
+	void setEnabled(const bool &enabled);
+	bool isEnabled() const;
+
+	// record an executed task (worker thread)
+	void record(const qint64 &enqueueNs, const qint64 &startNs, const qint64 &endNs);
+	void reset();
+
+	QLambdaThreadWorkerLatencyStats queueWaitStats() const;
+	QLambdaThreadWorkerLatencyStats runTimeStats() const;
+
+	// append trace events of the recorded tasks in chrome trace event format (comma separated)
+	void appendChromeTraceEvents(QByteArray &byteEvents, const QString &strName) const;
+
+	// monotonic clock shared by all workers, so traces of several workers can be merged
+	static qint64 nowNs();
+
+private:
+	Q_DISABLE_COPY(QLambdaThreadWorkerTrace)
+	QAtomicInt                                     m_enabled;
+	// thread id in exported traces
+	int                                            m_intTraceId;
+	QLambdaThreadWorkerHistogram                   m_queueWait;
+	QLambdaThreadWorkerHistogram                   m_runTime;
+	// created when tracing gets enabled for the first time, then kept until destroyed
+	QMutex                                         m_bufferMutex;
+	QAtomicPointer<QLambdaThreadWorkerTraceBuffer> mp_buffer;
+};
+
+// mailbox node stamped at enqueue, start and end of the wrapped node
+class QLambdaThreadWorkerTracedTask : public QEventMailboxNode
+{
+public:
+	// takes ownership of the node
+	QLambdaThreadWorkerTracedTask(QEventMailboxNode * p_node, QLambdaThreadWorkerTrace * p_trace);
+	// deletes wrapped node, executed or not (e.g. run tasks reject their deferred if dropped)
+	~QLambdaThreadWorkerTracedTask();
+
+	void exec();
+
+private:
+	QEventMailboxNode        * mp_node;
+	QLambdaThreadWorkerTrace * mp_trace;
+	qint64                     m_enqueueNs;
+};
+
+#endif // QLAMBDATHREADWORKERTRACE_H
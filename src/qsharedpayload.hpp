@@ -0,0 +1,98 @@
+#ifndef QSHAREDPAYLOAD_H
+#define QSHAREDPAYLOAD_H
+
+#include <QSharedPointer>
+#include <utility>
+
+// immutable reference counted payload, to pass large arguments to QDynamicEvents and QDeferred callbacks
+// NOTE : * callbacks capture their arguments by value when queued to other threads, for a plain struct
+//          or std::vector that is a deep copy per subscriber, for a QSharedPayload only a reference count
+//          increment, all subscribers in all threads read the same buffer
+//        * the value cannot be modified once wrapped, so sharing it across threads is safe
+//        * use QSharedPayload<T>::make(...) to construct the value in place without any copy
+template<class T>
+class QSharedPayload
+{
+public:
+	QSharedPayload();
+	QSharedPayload(const T &value);
+	QSharedPayload(T &&value);
+
+	// construct value in place
+	template<class ...Args>
+	static QSharedPayload<T> make(Args&&... args);
+
+	// read access
+	const T &operator*() const;
+	const T *operator->() const;
+	const T *data() const;
+	// no value wrapped
+	bool isNull() const;
+	// copy of the value, e.g. to modify it and wrap it again
+	T detached() const;
+
+private:
+	QSharedPointer<const T> m_data;
+};
+
+template<class T>
+QSharedPayload<T>::QSharedPayload() : m_data(nullptr)
+{
+	// nothing to do here
+}
+
+template<class T>
+QSharedPayload<T>::QSharedPayload(const T &value) : m_data(new T(value))
+{
+	// nothing to do here
+}
+
+template<class T>
+QSharedPayload<T>::QSharedPayload(T &&value) : m_data(new T(std::move(value)))
+{
+	// nothing to do here
+}
+
+template<class T>
+template<class ...Args>
+QSharedPayload<T> QSharedPayload<T>::make(Args&&... args)
+{
+	QSharedPayload<T> payload;
+	payload.m_data = QSharedPointer<const T>(new T(std::forward<Args>(args)...));
+	return payload;
+}
+
+template<class T>
+const T & QSharedPayload<T>::operator*() const
+{
+	Q_ASSERT_X(m_data, "QSharedPayload<T>::operator*", "Null payload.");
+	return *m_data;
+}
+
+template<class T>
+const T * QSharedPayload<T>::operator->() const
+{
+	Q_ASSERT_X(m_data, "QSharedPayload<T>::operator->", "Null payload.");
+	return m_data.data();
+}
+
+template<class T>
+const T * QSharedPayload<T>::data() const
+{
+	return m_data.data();
+}
+
+template<class T>
+bool QSharedPayload<T>::isNull() const
+{
+	return m_data.isNull();
+}
+
+template<class T>
+T QSharedPayload<T>::detached() const
+{
+	Q_ASSERT_X(m_data, "QSharedPayload<T>::detached", "Null payload.");
+	return T(*m_data);
+}
+
+#endif // QSHAREDPAYLOAD_H
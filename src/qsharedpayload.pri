@@ -0,0 +1,8 @@
+CONFIG += c++11
+CONFIG -= flat
+
+INCLUDEPATH += $$PWD/
+
+HEADERS     += $$PWD/qsharedpayload.hpp
+
+DEFINES     += QSHAREDPAYLOAD_USED
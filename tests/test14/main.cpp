@@ -0,0 +1,232 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <QDynamicEvents>
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+// NOTE : * cannot use catch to test threaded functionality.
+//        * needed to provide a custom main() function, to
+//        be able to initialize the QCoreApplication.
+
+int main(int argc, char* argv[])
+{
+	// global setup...
+	QCoreApplication a(argc, argv);
+
+	int result = Catch::Session().run(argc, argv);
+
+	// global clean-up...
+
+	return (result < 0xff ? result : 0xff);
+}
+
+TEST_CASE("Should match single level wildcard", "[on][trigger][wildcard]")
+{
+	// init
+	QDynamicEvents<int> eventer;
+	QStringList listCalled;
+	eventer.on("sensor.*", [&listCalled](int) {
+		listCalled.append("sensor.*");
+	});
+	int value = 1;
+	eventer.trigger("sensor.temp", value);
+	eventer.trigger("sensor.temp.zone3", value);
+	eventer.trigger("sensor", value);
+	// test
+	REQUIRE(listCalled.count() == 1);
+}
+
+TEST_CASE("Should match multi level wildcard", "[on][trigger][wildcard]")
+{
+	// init
+	QDynamicEvents<int> eventer;
+	int count = 0;
+	eventer.on("sensor.temp.#", [&count](int) {
+		count++;
+	});
+	int value = 1;
+	eventer.trigger("sensor.temp", value);
+	eventer.trigger("sensor.temp.zone3", value);
+	eventer.trigger("sensor.temp.zone3.max", value);
+	eventer.trigger("sensor.humidity.zone3", value);
+	// test
+	REQUIRE(count == 3);
+}
+
+TEST_CASE("Should call exact and wildcard subscribers once per trigger", "[on][trigger][wildcard]")
+{
+	// init
+	QDynamicEvents<int> eventer;
+	int countExact    = 0;
+	int countWildcard = 0;
+	eventer.on("sensor.temp.zone3", [&countExact](int) {
+		countExact++;
+	});
+	eventer.on("sensor.*.zone3 sensor.#", [&countWildcard](int) {
+		countWildcard++;
+	});
+	int value = 1;
+	eventer.trigger("sensor.temp.zone3", value);
+	// test
+	REQUIRE(countExact    == 1);
+	REQUIRE(countWildcard == 2);
+}
+
+TEST_CASE("Should stop matching after wildcard is removed", "[off][wildcard]")
+{
+	// init
+	QDynamicEvents<int> eventer;
+	int count = 0;
+	eventer.on("sensor.*", [&count](int) {
+		count++;
+	});
+	int value = 1;
+	eventer.trigger("sensor.temp", value);
+	eventer.off("sensor.*");
+	eventer.trigger("sensor.temp", value);
+	// test
+	REQUIRE(count == 1);
+}
+
+TEST_CASE("Should deliver high priority queued callbacks first", "[on][trigger][priority]")
+{
+	// init
+	QDynamicEvents<int> eventer;
+	QList<int> listCalled;
+	eventer.on("data", [&listCalled](int value) {
+		listCalled.append(value);
+	}, nullptr, Qt::QueuedConnection);
+	eventer.on("control", [&listCalled](int value) {
+		listCalled.append(value);
+	}, nullptr, Qt::QueuedConnection, Qt::HighEventPriority);
+	int dataValue    = 1;
+	int controlValue = 2;
+	eventer.trigger("data", dataValue);
+	eventer.trigger("data", dataValue);
+	eventer.trigger("control", controlValue);
+	eventer.trigger(Qt::HighEventPriority, "data", controlValue);
+	// test
+	REQUIRE(QDynamicEvents<int>::laneMetrics().at(0).depth == 2);
+	REQUIRE(QDynamicEvents<int>::laneMetrics().at(1).depth == 2);
+	QCoreApplication::processEvents();
+	REQUIRE(listCalled == (QList<int>() << 2 << 2 << 1 << 1));
+	REQUIRE(QDynamicEvents<int>::laneMetrics().at(0).depth    == 0);
+	REQUIRE(QDynamicEvents<int>::laneMetrics().at(0).maxDepth >= 2);
+}
+
+TEST_CASE("Should deliver retained value to late subscribers", "[on][once][trigger][retained]")
+{
+	// init
+	QDynamicEvents<int> eventer;
+	eventer.setRetained("state");
+	int value = 3;
+	eventer.trigger("state", value);
+	value = 5;
+	eventer.trigger("state", value);
+	int lastOn   = 0;
+	int countOn  = 0;
+	eventer.on("state", [&lastOn, &countOn](int value) {
+		lastOn = value;
+		countOn++;
+	});
+	int lastOnce  = 0;
+	int countOnce = 0;
+	eventer.once("state", [&lastOnce, &countOnce](int value) {
+		lastOnce = value;
+		countOnce++;
+	});
+	// test
+	REQUIRE(lastOn    == 5);
+	REQUIRE(lastOnce  == 5);
+	// once callback already consumed by the retained value
+	value = 7;
+	eventer.trigger("state", value);
+	REQUIRE(countOn   == 2);
+	REQUIRE(countOnce == 1);
+	// no retained value after clear
+	eventer.clearRetained("state");
+	int countLate = 0;
+	eventer.on("state", [&countLate](int) {
+		countLate++;
+	});
+	REQUIRE(countLate == 0);
+}
+
+TEST_CASE("Should call sampled subscriber every N triggers", "[on][trigger][rate]")
+{
+	// init
+	QDynamicEvents<int> eventer;
+	QList<int> listCalled;
+	eventer.on("sample", [&listCalled](int value) {
+		listCalled.append(value);
+	}, nullptr, Qt::AutoConnection, Qt::NormalEventPriority, QDynamicEventsRate::sample(3));
+	for (int i = 1; i <= 10; i++)
+	{
+		eventer.trigger("sample", i);
+	}
+	// test
+	REQUIRE(listCalled == (QList<int>() << 3 << 6 << 9));
+}
+
+TEST_CASE("Should call debounced subscriber once with last args", "[on][trigger][rate]")
+{
+	// init
+	QDynamicEvents<int> eventer;
+	QList<int> listCalled;
+	eventer.on("debounce", [&listCalled](int value) {
+		listCalled.append(value);
+	}, nullptr, Qt::AutoConnection, Qt::NormalEventPriority, QDynamicEventsRate::debounce(20));
+	for (int i = 1; i <= 10; i++)
+	{
+		eventer.trigger("debounce", i);
+	}
+	// nothing delivered while triggering
+	REQUIRE(listCalled.isEmpty());
+	// run event loop until debounce interval is over
+	QElapsedTimer timer;
+	timer.start();
+	while (timer.elapsed() < 100)
+	{
+		QCoreApplication::processEvents();
+	}
+	// test
+	REQUIRE(listCalled == (QList<int>() << 10));
+}
+
+TEST_CASE("Should queue trailing throttled calls with the trigger priority", "[on][trigger][rate][priority]")
+{
+	// init
+	QDynamicEvents<int> eventer;
+	QList<int> listCalled;
+	eventer.on("normal", [&listCalled](int value) {
+		listCalled.append(value);
+	}, nullptr, Qt::QueuedConnection, Qt::NormalEventPriority, QDynamicEventsRate::throttle(20));
+	eventer.on("high", [&listCalled](int value) {
+		listCalled.append(value);
+	}, nullptr, Qt::QueuedConnection, Qt::NormalEventPriority, QDynamicEventsRate::throttle(20));
+	// leading calls
+	int normalValue = 1;
+	int highValue   = 2;
+	eventer.trigger("normal", normalValue);
+	eventer.trigger("high", highValue);
+	QCoreApplication::processEvents();
+	REQUIRE(listCalled == (QList<int>() << 1 << 2));
+	// trailing calls, both intervals are over before the event loop runs again
+	normalValue = 10;
+	highValue   = 20;
+	eventer.trigger("normal", normalValue);
+	eventer.trigger(Qt::HighEventPriority, "high", highValue);
+	QThread::msleep(50);
+	QElapsedTimer timer;
+	timer.start();
+	while (timer.elapsed() < 100)
+	{
+		QCoreApplication::processEvents();
+	}
+	// test, both expire together so the trailing call with high priority goes first although it expired last
+	REQUIRE(listCalled == (QList<int>() << 1 << 2 << 20 << 10));
+}
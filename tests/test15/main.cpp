@@ -0,0 +1,129 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QThread>
+#include <QDebug>
+
+#include "qeventmailbox.hpp"
+
+// NOTE : cross-thread benchmark, compares posting one QEvent per callback
+//        against the lock-free mailbox used internally by the library
+
+#define BENCH_EVENT_TYPE   (QEvent::Type)(QEvent::User + 1)
+#define BENCH_MAILBOX_TYPE (QEvent::Type)(QEvent::User + 2)
+
+class BenchEvent : public QEvent
+{
+public:
+	BenchEvent() : QEvent(BENCH_EVENT_TYPE) { }
+
+	std::function<void()> m_eventFunc;
+};
+
+class BenchReceiver : public QObject
+{
+public:
+	BenchReceiver() : QObject(nullptr), m_mailbox(this, BENCH_MAILBOX_TYPE) { }
+
+	bool event(QEvent * ev)
+	{
+		if (ev->type() == BENCH_EVENT_TYPE) {
+			static_cast<BenchEvent*>(ev)->m_eventFunc();
+			return true;
+		}
+		if (ev->type() == BENCH_MAILBOX_TYPE) {
+			m_mailbox.drain();
+			return true;
+		}
+		return QObject::event(ev);
+	}
+
+	void post(const std::function<void()> &func, bool useMailbox)
+	{
+		if (useMailbox)
+		{
+			m_mailbox.post(func);
+			return;
+		}
+		BenchEvent * p_Evt = new BenchEvent;
+		p_Evt->m_eventFunc = func;
+		QCoreApplication::postEvent(this, p_Evt);
+	}
+
+private:
+	QEventMailbox m_mailbox;
+};
+
+// bounce a callback between main and worker thread
+double pingPongNsecs(BenchReceiver * p_main, BenchReceiver * p_worker, int roundTrips, bool useMailbox)
+{
+	QEventLoop loop;
+	int count = 0;
+	std::function<void()> ping;
+	std::function<void()> pong = [&]() {
+		if (++count == roundTrips)
+		{
+			loop.quit();
+			return;
+		}
+		p_worker->post(ping, useMailbox);
+	};
+	ping = [&]() {
+		p_main->post(pong, useMailbox);
+	};
+	QElapsedTimer timer;
+	timer.start();
+	p_worker->post(ping, useMailbox);
+	loop.exec();
+	return (double)timer.nsecsElapsed() / roundTrips;
+}
+
+// post a burst of callbacks to the worker thread
+double throughputPerSec(BenchReceiver * p_main, BenchReceiver * p_worker, int numCallbacks, bool useMailbox)
+{
+	QEventLoop loop;
+	int count = 0;
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < numCallbacks; i++)
+	{
+		p_worker->post([&]() {
+			if (++count == numCallbacks)
+			{
+				p_main->post([&]() {
+					loop.quit();
+				}, useMailbox);
+			}
+		}, useMailbox);
+	}
+	loop.exec();
+	return numCallbacks * 1e9 / timer.nsecsElapsed();
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QThread workerThread;
+	BenchReceiver mainReceiver;
+	BenchReceiver * p_workerReceiver = new BenchReceiver;
+	p_workerReceiver->moveToThread(&workerThread);
+	workerThread.start();
+
+	const int roundTrips   = 100000;
+	const int numCallbacks = 1000000;
+	for (int run = 0; run < 3; run++)
+	{
+		qDebug() << "[INFO] Run" << run;
+		qDebug() << "[INFO] Ping-pong postEvent =" << pingPongNsecs(&mainReceiver, p_workerReceiver, roundTrips, false) << "ns per round trip";
+		qDebug() << "[INFO] Ping-pong mailbox   =" << pingPongNsecs(&mainReceiver, p_workerReceiver, roundTrips, true ) << "ns per round trip";
+		qDebug() << "[INFO] Burst postEvent     =" << throughputPerSec(&mainReceiver, p_workerReceiver, numCallbacks, false) << "callbacks per second";
+		qDebug() << "[INFO] Burst mailbox       =" << throughputPerSec(&mainReceiver, p_workerReceiver, numCallbacks, true ) << "callbacks per second";
+	}
+
+	p_workerReceiver->deleteLater();
+	workerThread.quit();
+	workerThread.wait();
+
+	return 0;
+}
@@ -0,0 +1,95 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QDebug>
+#include <vector>
+
+#include <QDynamicEvents>
+#include <QSharedPayload>
+#include <QLambdaThreadWorker>
+
+// NOTE : allocation benchmark, counts deep copies of a large payload triggered to
+//        many subscribers in many threads, plain struct against QSharedPayload
+
+static QAtomicInt s_copies;
+
+struct Frame
+{
+	Frame() : pixels(4 * 1024 * 1024) { }
+	Frame(const Frame &other) : pixels(other.pixels) { s_copies.fetchAndAddRelaxed(1); }
+	Frame &operator=(const Frame &other) { pixels = other.pixels; s_copies.fetchAndAddRelaxed(1); return *this; }
+
+	std::vector<char> pixels;
+};
+
+// wait until all workers executed a function
+void waitCount(QAtomicInt &count, int expected)
+{
+	while (count.loadAcquire() < expected)
+	{
+		QCoreApplication::processEvents();
+	}
+}
+
+template<class T>
+void runBenchmark(const QString &strName, QList<QLambdaThreadWorker*> &listWorkers, int numSubscribers, int numTriggers, T &value)
+{
+	QDynamicEvents<T> eventer;
+	QAtomicInt subscribed;
+	QAtomicInt called;
+	// subscribe in each worker thread
+	for (int i = 0; i < listWorkers.count(); i++)
+	{
+		listWorkers[i]->execInThread([&eventer, &subscribed, &called, numSubscribers]() {
+			for (int j = 0; j < numSubscribers; j++)
+			{
+				eventer.on("frame", [&called](T &) {
+					called.fetchAndAddRelaxed(1);
+				});
+			}
+			subscribed.fetchAndAddRelaxed(1);
+		});
+	}
+	waitCount(subscribed, listWorkers.count());
+	// trigger from main thread
+	s_copies.storeRelease(0);
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < numTriggers; i++)
+	{
+		eventer.trigger("frame", value);
+	}
+	waitCount(called, numTriggers * numSubscribers * listWorkers.count());
+	qint64 nsecs = timer.nsecsElapsed();
+	int totalCalls = numTriggers * numSubscribers * listWorkers.count();
+	qDebug() << "[INFO]" << strName << "copies per callback =" << (double)s_copies.loadAcquire() / totalCalls
+	         << ", ns per callback =" << (double)nsecs / totalCalls;
+	eventer.off();
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	const int numThreads     = 4;
+	const int numSubscribers = 8;
+	const int numTriggers    = 50;
+	QList<QLambdaThreadWorker*> listWorkers;
+	for (int i = 0; i < numThreads; i++)
+	{
+		listWorkers.append(new QLambdaThreadWorker);
+	}
+
+	Frame frame;
+	QSharedPayload<Frame> payload = QSharedPayload<Frame>::make();
+	for (int run = 0; run < 3; run++)
+	{
+		qDebug() << "[INFO] Run" << run;
+		runBenchmark<Frame>("Plain struct  ", listWorkers, numSubscribers, numTriggers, frame);
+		runBenchmark<QSharedPayload<Frame>>("QSharedPayload", listWorkers, numSubscribers, numTriggers, payload);
+	}
+
+	qDeleteAll(listWorkers);
+
+	return 0;
+}
@@ -0,0 +1,89 @@
+#include <QCoreApplication>
+#include <QAtomicInt>
+#include <QDebug>
+
+#include <QEventer>
+#include <QLambdaThreadWorker>
+
+// NOTE : stress test, many threads subscribe and trigger new type signatures on a
+//        shared QEventer at the same time, without any external mutex
+
+// a different type signature per N
+template<int N>
+struct Tag
+{
+	int value;
+};
+
+static QAtomicInt s_called;
+
+// subscribe and trigger all signatures from 0 to N
+template<int N>
+struct TagRunner
+{
+	static void run(QEventer &eventer, const QString &strEventName)
+	{
+		TagRunner<N - 1>::run(eventer, strEventName);
+		// NOTE : explicit std::function so Types... can be deduced
+		std::function<void(Tag<N>&)> callback = [](Tag<N> &tag) {
+			Q_ASSERT(tag.value == N);
+			s_called.fetchAndAddRelaxed(1);
+		};
+		std::function<bool(Tag<N>&)> filter = [](Tag<N> &) {
+			return true;
+		};
+		eventer.on<Tag<N>>(strEventName, callback, filter, Qt::DirectConnection);
+		Tag<N> tag;
+		tag.value = N;
+		eventer.trigger<Tag<N>>(strEventName, tag);
+	}
+};
+
+template<>
+struct TagRunner<-1>
+{
+	static void run(QEventer &, const QString &) { }
+};
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	const int numThreads = 8;
+	const int numTags    = 32;
+	const int numRounds  = 20;
+	for (int round = 0; round < numRounds; round++)
+	{
+		QEventer eventer;
+		QAtomicInt finished;
+		s_called.storeRelease(0);
+		QList<QLambdaThreadWorker*> listWorkers;
+		for (int i = 0; i < numThreads; i++)
+		{
+			listWorkers.append(new QLambdaThreadWorker);
+		}
+		// each thread uses its own event name, so it only gets its own callbacks
+		for (int i = 0; i < numThreads; i++)
+		{
+			QString strEventName = QString("thread%1").arg(i);
+			listWorkers[i]->execInThread([&eventer, &finished, strEventName]() {
+				TagRunner<numTags - 1>::run(eventer, strEventName);
+				finished.fetchAndAddRelaxed(1);
+			});
+		}
+		while (finished.loadAcquire() < numThreads)
+		{
+			QCoreApplication::processEvents();
+		}
+		qDeleteAll(listWorkers);
+		// test
+		if (s_called.loadAcquire() != numThreads * numTags)
+		{
+			qDebug() << "[ERROR] Round" << round << "called" << s_called.loadAcquire() << "times, expected" << numThreads * numTags;
+			return 1;
+		}
+	}
+	qDebug() << "[INFO] All callbacks called, no eventer got lost";
+
+	return 0;
+}
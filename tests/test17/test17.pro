@@ -0,0 +1,15 @@
+QT += core
+QT -= gui
+
+TARGET = test17
+CONFIG += console
+CONFIG -= app_bundle
+
+include(./../../src/qeventer.pri)
+include(./../../src/qlambdathreadworker.pri)
+
+TEMPLATE = app
+
+SOURCES += main.cpp
+
+include(./../add_qt_path.pri)
@@ -0,0 +1,121 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QSemaphore>
+#include <QMap>
+#include <QDebug>
+
+#include <QLambdaThreadPool>
+
+// NOTE : a burst of tasks submitted from the main thread must be spread across all workers
+//        of the pool, tasks queued in a busy worker must be stolen by the others,
+//        tasks pinned to a worker must run in that worker's thread
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	const int numThreads = 4;
+	const int numTasks   = 2000;
+	QLambdaThreadPool pool(numThreads);
+
+	QMutex mutex;
+	QMap<QThread*, int> mapTasksPerThread;
+	QAtomicInt executed;
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < numTasks; i++)
+	{
+		pool.execInThread([&mutex, &mapTasksPerThread, &executed]() {
+			// simulate some work
+			QThread::usleep(200);
+			QMutexLocker locker(&mutex);
+			mapTasksPerThread[QThread::currentThread()]++;
+			executed.fetchAndAddRelaxed(1);
+		});
+	}
+	while (executed.loadAcquire() < numTasks)
+	{
+		QCoreApplication::processEvents();
+	}
+	qDebug() << "[INFO] Executed" << numTasks << "tasks in" << timer.elapsed() << "ms, using" << mapTasksPerThread.count() << "threads";
+	for (auto it = mapTasksPerThread.constBegin(); it != mapTasksPerThread.constEnd(); ++it)
+	{
+		qDebug() << "[INFO] Thread" << it.key() << "executed" << it.value() << "tasks";
+	}
+	if (mapTasksPerThread.count() != numThreads)
+	{
+		qDebug() << "[ERROR] Burst was not spread across all workers";
+		return 1;
+	}
+
+	// work stealing, tasks submitted from a worker go to its own queue, while it is blocked the others must steal them
+	const int numStolen = 200;
+	QThread * p_blocked = pool.getWorker(0).getThread();
+	QAtomicInt stolen;
+	QAtomicInt notStolen;
+	QAtomicInt blockerOk;
+	QAtomicInt blockerDone;
+	QSemaphore semStolen;
+	pool.execInThread([pool, p_blocked, numStolen, &stolen, &notStolen, &blockerOk, &blockerDone, &semStolen]() mutable {
+		for (int i = 0; i < numStolen; i++)
+		{
+			pool.execInThread([p_blocked, &stolen, &notStolen, &semStolen]() {
+				if (QThread::currentThread() == p_blocked)
+				{
+					notStolen.fetchAndAddRelaxed(1);
+				}
+				else
+				{
+					stolen.fetchAndAddRelaxed(1);
+				}
+				semStolen.release();
+			});
+		}
+		// keep this worker busy until all tasks of its queue were executed
+		blockerOk.storeRelease(semStolen.tryAcquire(numStolen, 10000) ? 1 : 0);
+		blockerDone.storeRelease(1);
+	}, Qt::NormalEventPriority, 0);
+	while (!blockerDone.loadAcquire())
+	{
+		QCoreApplication::processEvents();
+	}
+	qDebug() << "[INFO] Stolen tasks" << stolen.loadAcquire() << ", executed by the busy worker" << notStolen.loadAcquire();
+	if (!blockerOk.loadAcquire() || stolen.loadAcquire() != numStolen || notStolen.loadAcquire() != 0)
+	{
+		qDebug() << "[ERROR] Tasks queued in a busy worker were not stolen";
+		return 1;
+	}
+
+	// pinned tasks
+	QAtomicInt pinnedOk;
+	for (int i = 0; i < numThreads; i++)
+	{
+		QThread * p_expected = pool.getWorker(i).getThread();
+		pool.execInThread([p_expected, &pinnedOk]() {
+			if (QThread::currentThread() == p_expected)
+			{
+				pinnedOk.fetchAndAddRelaxed(1);
+			}
+		}, Qt::NormalEventPriority, i);
+	}
+
+	// quit all workers once pinned tasks are done
+	bool finished = false;
+	pool.quitThread().done([&finished]() {
+		finished = true;
+	});
+	while (!finished)
+	{
+		QCoreApplication::processEvents();
+	}
+	if (pinnedOk.loadAcquire() != numThreads)
+	{
+		qDebug() << "[ERROR] Pinned task executed in wrong thread";
+		return 1;
+	}
+	qDebug() << "[INFO] Pinned tasks executed in their workers";
+
+	return 0;
+}
@@ -0,0 +1,77 @@
+#include <QCoreApplication>
+#include <QAtomicInt>
+#include <QDebug>
+
+#include <QLambdaThreadWorker>
+
+// NOTE : callbacks submitted concurrently from several threads must all be accounted for,
+//        statistics must be consistent once the worker is idle
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	const int numProducers = 4;
+	const int numTasks     = 5000;
+	QLambdaThreadWorker worker;
+	QList<QLambdaThreadWorker*> listProducers;
+	for (int i = 0; i < numProducers; i++)
+	{
+		listProducers.append(new QLambdaThreadWorker);
+	}
+
+	QAtomicInt executed;
+	for (int i = 0; i < numProducers; i++)
+	{
+		listProducers[i]->execInThread([&worker, &executed, numTasks]() {
+			for (int j = 0; j < numTasks; j++)
+			{
+				worker.execInThread([&executed]() {
+					executed.fetchAndAddRelaxed(1);
+				});
+			}
+		});
+	}
+	while (executed.loadAcquire() < numProducers * numTasks)
+	{
+		QCoreApplication::processEvents();
+	}
+
+	// quit producers first, then the worker
+	for (int i = 0; i < numProducers; i++)
+	{
+		bool finished = false;
+		listProducers[i]->quitThread().done([&finished]() {
+			finished = true;
+		});
+		while (!finished)
+		{
+			QCoreApplication::processEvents();
+		}
+		delete listProducers[i];
+	}
+	bool finished = false;
+	worker.quitThread().done([&finished]() {
+		finished = true;
+	});
+	while (!finished)
+	{
+		QCoreApplication::processEvents();
+	}
+
+	QLambdaThreadWorkerStats stats = worker.getStats();
+	qDebug() << "[INFO] Submitted" << stats.submitted << "executed" << stats.executed
+		<< "max depth" << stats.maxDepth << "busy" << stats.busyNs / 1000 << "us";
+	if (stats.submitted != (quint64)(numProducers * numTasks) || stats.executed != stats.submitted)
+	{
+		qDebug() << "[ERROR] Callbacks not accounted for";
+		return 1;
+	}
+	if (stats.depth != 0 || stats.maxDepth == 0 || stats.maxDepth > stats.submitted)
+	{
+		qDebug() << "[ERROR] Inconsistent queue depth";
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,73 @@
+#include <QCoreApplication>
+#include <QAtomicInt>
+#include <QDebug>
+
+#include <QLambdaThreadWorker>
+
+// NOTE : a fixed rate loop must not drift, every period elapsed since the loop started
+//        is either executed or reported as missed, starting it from another thread is not a callback in the stats
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QLambdaThreadWorker worker;
+	const quint64 periodUs  = 1000;
+	const int     numTicks  = 500;
+
+	QAtomicInt finished;
+	qint64 maxLatenessNs = 0;
+	QLambdaThreadWorkerLoopTick lastTick;
+	int loopId = worker.startLoopInThread([&](const QLambdaThreadWorkerLoopTick &tick) {
+		if (finished.loadAcquire())
+		{
+			return;
+		}
+		maxLatenessNs = qMax(maxLatenessNs, tick.latenessNs);
+		// scheduled times must stay on the grid
+		if (tick.scheduledNs % (qint64)(periodUs * 1000) != 0)
+		{
+			qDebug() << "[ERROR] Tick scheduled out of the grid" << tick.scheduledNs;
+		}
+		lastTick = tick;
+		if (tick.tick + tick.totalMissedTicks + 1 >= (quint64)numTicks)
+		{
+			finished.storeRelease(1);
+		}
+	}, QLambdaThreadWorkerLoopOptions(periodUs, Qt::PreciseTimer, 
+		                              QLambdaThreadWorkerLoopOptions::FixedRate, 
+		                              QLambdaThreadWorkerLoopOptions::Skip));
+	while (!finished.loadAcquire())
+	{
+		QCoreApplication::processEvents();
+		QThread::msleep(1);
+	}
+	// arming the timer from this thread is internal, not a callback in the stats
+	QLambdaThreadWorkerStats stats = worker.getStats();
+	if (stats.submitted != 0 || stats.executed != 0)
+	{
+		qDebug() << "[ERROR] Loop start counted as callbacks, submitted" << stats.submitted << ", executed" << stats.executed;
+		return 1;
+	}
+	worker.stopLoopInThread(loopId);
+
+	bool quit = false;
+	worker.quitThread().done([&quit]() {
+		quit = true;
+	});
+	while (!quit)
+	{
+		QCoreApplication::processEvents();
+	}
+
+	qDebug() << "[INFO] Executed" << lastTick.tick + 1 << "ticks, missed" << lastTick.totalMissedTicks 
+		<< ", max lateness" << maxLatenessNs / 1000 << "us, overruns" << lastTick.overruns;
+	// every period is either executed or missed, so the last tick is due exactly that many periods after start
+	if (lastTick.scheduledNs != (qint64)((lastTick.tick + lastTick.totalMissedTicks + 1) * periodUs * 1000))
+	{
+		qDebug() << "[ERROR] Loop drifted, last tick scheduled at" << lastTick.scheduledNs;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,73 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QVector>
+#include <QDebug>
+
+#include <QLambdaThreadWorker>
+
+// NOTE : a single worker must handle thousands of concurrent loops, loops stopped
+//        must not execute anymore once the returned deferred is resolved
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	const int numLoops = 10000;
+	const int numMs    = 10;
+	QLambdaThreadWorker worker;
+
+	QAtomicInt ticks;
+	QVector<int> vecLoopIds;
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < numLoops; i++)
+	{
+		vecLoopIds.append(worker.startLoopInThread([&ticks]() {
+			ticks.fetchAndAddRelaxed(1);
+		}, numMs));
+	}
+	qDebug() << "[INFO] Started" << numLoops << "loops in" << timer.elapsed() << "ms";
+
+	// let every loop tick a few times
+	while (ticks.loadAcquire() < numLoops * 5)
+	{
+		QCoreApplication::processEvents();
+		QThread::msleep(1);
+	}
+	qDebug() << "[INFO]" << ticks.loadAcquire() << "ticks after" << timer.elapsed() << "ms";
+
+	// stop half of the loops one by one, the rest all at once
+	QList<QDefer> listDefers;
+	for (int i = 0; i < numLoops / 2; i++)
+	{
+		listDefers.append(worker.stopLoopInThread(vecLoopIds.at(i)));
+	}
+	listDefers.append(worker.stopAllLoopsInThread());
+	bool stopped = false;
+	QDefer::when(listDefers).done([&stopped]() {
+		stopped = true;
+	});
+	while (!stopped)
+	{
+		QCoreApplication::processEvents();
+	}
+	int ticksStopped = ticks.loadAcquire();
+	QThread::msleep(5 * numMs);
+	if (ticks.loadAcquire() != ticksStopped)
+	{
+		qDebug() << "[ERROR] Loops executed after being stopped";
+		return 1;
+	}
+
+	bool quit = false;
+	worker.quitThread().done([&quit]() {
+		quit = true;
+	});
+	while (!quit)
+	{
+		QCoreApplication::processEvents();
+	}
+
+	return 0;
+}
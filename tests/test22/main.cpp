@@ -0,0 +1,81 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QDebug>
+#include <vector>
+#include <algorithm>
+
+#include <QLambdaThreadWorker>
+
+// NOTE : latency benchmark, a deferred resolved in worker B and handled back in worker A,
+//        round-trip percentiles with both threads free to migrate against both threads pinned
+
+// send next request from worker A, measure when the result is back in A
+void roundTrip(QLambdaThreadWorker &workerB, std::vector<qint64> &vecLatencies, int numRounds, QAtomicInt &finished)
+{
+	QElapsedTimer timer;
+	timer.start();
+	workerB.run([]() {
+		return 0;
+	}).done([&workerB, &vecLatencies, numRounds, &finished, timer](int) {
+		vecLatencies.push_back(timer.nsecsElapsed());
+		if ((int)vecLatencies.size() >= numRounds)
+		{
+			finished.storeRelease(1);
+			return;
+		}
+		roundTrip(workerB, vecLatencies, numRounds, finished);
+	});
+}
+
+void runBenchmark(const QString &strName, const QLambdaThreadWorkerOptions &optionsA, const QLambdaThreadWorkerOptions &optionsB, int numRounds)
+{
+	QLambdaThreadWorker workerA(optionsA);
+	QLambdaThreadWorker workerB(optionsB);
+	std::vector<qint64> vecLatencies;
+	vecLatencies.reserve(numRounds);
+	QAtomicInt finished;
+	workerA.execInThread([&workerB, &vecLatencies, numRounds, &finished]() {
+		roundTrip(workerB, vecLatencies, numRounds, finished);
+	});
+	while (!finished.loadAcquire())
+	{
+		QCoreApplication::processEvents();
+		QThread::msleep(1);
+	}
+	std::sort(vecLatencies.begin(), vecLatencies.end());
+	auto percentile = [&vecLatencies](double p) {
+		return vecLatencies.at(qMin((size_t)(p * vecLatencies.size()), vecLatencies.size() - 1)) / 1000.0;
+	};
+	qDebug() << "[INFO]" << strName << "round trip us : p50" << percentile(0.5) << ", p99" << percentile(0.99) 
+		<< ", p99.9" << percentile(0.999) << ", max" << vecLatencies.back() / 1000.0;
+	// wait for both threads
+	bool quitA = false;
+	bool quitB = false;
+	workerA.quitThread().done([&quitA]() { quitA = true; });
+	workerB.quitThread().done([&quitB]() { quitB = true; });
+	while (!quitA || !quitB)
+	{
+		QCoreApplication::processEvents();
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	const int numRounds = 100000;
+	runBenchmark("Unpinned", 
+		QLambdaThreadWorkerOptions("bench-a"), 
+		QLambdaThreadWorkerOptions("bench-b"), numRounds);
+	if (QThread::idealThreadCount() < 2)
+	{
+		qDebug() << "[INFO] Single cpu, skipping pinned benchmark";
+		return 0;
+	}
+	runBenchmark("Pinned", 
+		QLambdaThreadWorkerOptions("bench-a", QThread::InheritPriority, 0, QList<int>() << 0), 
+		QLambdaThreadWorkerOptions("bench-b", QThread::InheritPriority, 0, QList<int>() << 1), numRounds);
+
+	return 0;
+}
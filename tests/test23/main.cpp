@@ -0,0 +1,99 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QDebug>
+
+#include <QLambdaThreadWorker>
+
+// NOTE : quitting must resolve promptly for idle workers, drop pending callbacks when asked to
+//        and respect the deadline when draining a long queue
+
+// quit and wait, returns number of dropped callbacks
+quint32 quitAndWait(QLambdaThreadWorker &worker, const QLambdaThreadWorkerQuitOptions &options, qint64 &msElapsed)
+{
+	QElapsedTimer timer;
+	timer.start();
+	bool    finished = false;
+	quint32 dropped  = 0;
+	worker.quitThread(options).done([&finished, &dropped](quint32 count) {
+		dropped  = count;
+		finished = true;
+	});
+	while (!finished)
+	{
+		QCoreApplication::processEvents();
+	}
+	msElapsed = timer.elapsed();
+	return dropped;
+}
+
+// queue slow callbacks
+void queueSlow(QLambdaThreadWorker &worker, QAtomicInt &executed, int numTasks)
+{
+	for (int i = 0; i < numTasks; i++)
+	{
+		worker.execInThread([&executed]() {
+			QThread::msleep(10);
+			executed.fetchAndAddRelaxed(1);
+		});
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	qint64 msElapsed = 0;
+	// idle worker
+	{
+		QLambdaThreadWorker worker;
+		quint32 dropped = quitAndWait(worker, QLambdaThreadWorkerQuitOptions(QLambdaThreadWorkerQuitOptions::DrainAll), msElapsed);
+		qDebug() << "[INFO] Idle worker quit in" << msElapsed << "ms";
+		if (dropped != 0)
+		{
+			qDebug() << "[ERROR] Idle worker dropped callbacks";
+			return 1;
+		}
+	}
+	// drain everything
+	{
+		QLambdaThreadWorker worker;
+		QAtomicInt executed;
+		queueSlow(worker, executed, 20);
+		quint32 dropped = quitAndWait(worker, QLambdaThreadWorkerQuitOptions(QLambdaThreadWorkerQuitOptions::CancelLoopsThenDrain), msElapsed);
+		qDebug() << "[INFO] Drained" << executed.loadAcquire() << "callbacks in" << msElapsed << "ms";
+		if (dropped != 0 || executed.loadAcquire() != 20)
+		{
+			qDebug() << "[ERROR] Callbacks not drained";
+			return 1;
+		}
+	}
+	// drop pending
+	{
+		QLambdaThreadWorker worker;
+		QAtomicInt executed;
+		queueSlow(worker, executed, 100);
+		quint32 dropped = quitAndWait(worker, QLambdaThreadWorkerQuitOptions(QLambdaThreadWorkerQuitOptions::DropPending), msElapsed);
+		qDebug() << "[INFO] Executed" << executed.loadAcquire() << ", dropped" << dropped << "in" << msElapsed << "ms";
+		if (executed.loadAcquire() + (int)dropped != 100 || msElapsed > 500)
+		{
+			qDebug() << "[ERROR] Pending callbacks not dropped";
+			return 1;
+		}
+	}
+	// drain with deadline
+	{
+		QLambdaThreadWorker worker;
+		QAtomicInt executed;
+		queueSlow(worker, executed, 100);
+		quint32 dropped = quitAndWait(worker, QLambdaThreadWorkerQuitOptions(QLambdaThreadWorkerQuitOptions::CancelLoopsThenDrain, 100), msElapsed);
+		qDebug() << "[INFO] Executed" << executed.loadAcquire() << ", dropped" << dropped << "in" << msElapsed << "ms";
+		if (executed.loadAcquire() + (int)dropped != 100 || dropped == 0 || msElapsed > 500)
+		{
+			qDebug() << "[ERROR] Deadline not respected";
+			return 1;
+		}
+	}
+
+	return 0;
+}
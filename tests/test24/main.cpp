@@ -0,0 +1,92 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QDebug>
+#include <vector>
+#include <algorithm>
+
+#include <QLambdaThreadWorker>
+#include <QLambdaThreadSpinWorker>
+
+// NOTE : latency benchmark, ping-pong between the main thread and a worker thread, event loop
+//        worker against spin worker, plus a check that deferreds of run() resolve in both
+
+template<class W>
+void runBenchmark(const QString &strName, W &worker, int numRounds)
+{
+	std::vector<qint64> vecLatencies;
+	vecLatencies.reserve(numRounds);
+	QAtomicInt pong;
+	QElapsedTimer timer;
+	for (int i = 0; i < numRounds; i++)
+	{
+		pong.storeRelease(0);
+		timer.start();
+		worker.execInThread([&pong]() {
+			pong.storeRelease(1);
+		});
+		while (!pong.loadAcquire())
+		{
+			// busy wait, measure the worker not the main thread
+		}
+		vecLatencies.push_back(timer.nsecsElapsed());
+	}
+	std::sort(vecLatencies.begin(), vecLatencies.end());
+	auto percentile = [&vecLatencies](double p) {
+		return vecLatencies.at(qMin((size_t)(p * vecLatencies.size()), vecLatencies.size() - 1)) / 1000.0;
+	};
+	qDebug() << "[INFO]" << strName << "ping-pong us : p50" << percentile(0.5) << ", p99" << percentile(0.99)
+		<< ", p99.9" << percentile(0.999) << ", max" << vecLatencies.back() / 1000.0;
+}
+
+template<class W>
+bool checkRun(W &worker)
+{
+	bool finished = false;
+	int  result   = 0;
+	worker.run([]() {
+		return 42;
+	}).done([&finished, &result](int value) {
+		result   = value;
+		finished = true;
+	});
+	while (!finished)
+	{
+		QCoreApplication::processEvents();
+	}
+	return result == 42;
+}
+
+template<class W>
+void quitAndWait(W &worker)
+{
+	bool finished = false;
+	worker.quitThread().done([&finished]() {
+		finished = true;
+	});
+	while (!finished)
+	{
+		QCoreApplication::processEvents();
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	const int numRounds = 100000;
+	QLambdaThreadWorker     eventWorker;
+	QLambdaThreadSpinWorker spinWorker;
+	runBenchmark("Event loop worker", eventWorker, numRounds);
+	runBenchmark("Spin worker", spinWorker, numRounds);
+	bool isOk = checkRun(eventWorker) && checkRun(spinWorker);
+	quitAndWait(eventWorker);
+	quitAndWait(spinWorker);
+	if (!isOk)
+	{
+		qDebug() << "[ERROR] Deferred not resolved with function result";
+		return 1;
+	}
+
+	return 0;
+}
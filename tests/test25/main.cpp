@@ -0,0 +1,98 @@
+#include <QCoreApplication>
+#include <QSemaphore>
+#include <QMutex>
+#include <QDebug>
+
+#include <QLambdaThreadWorker>
+
+// NOTE : callbacks queued while the worker is busy must run by level (highest first, FIFO within level),
+//        callbacks with deadline must run before any level in earliest deadline first order,
+//        also when a level has more pending callbacks than the mailbox streak limit (strict priority)
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QLambdaThreadWorker worker;
+	QSemaphore started;
+	QSemaphore gate;
+	QMutex     mutex;
+	QList<int> listOrder;
+	// block worker so everything else gets queued
+	worker.execInThread([&started, &gate]() {
+		started.release();
+		gate.acquire();
+	});
+	// wait until the blocking callback left the queue, so it is not counted in the depths nor reordered
+	started.acquire();
+	// more callbacks per level than the default mailbox streak limit (16), lowest level first
+	const int numPerLevel = 20;
+	for (int level = 0; level < QLAMBDATHREADWORKER_PRIORITY_LEVELS; level++)
+	{
+		for (int i = 0; i < numPerLevel; i++)
+		{
+			int id = level * 100 + i;
+			worker.execInThreadAtLevel([&mutex, &listOrder, id]() {
+				QMutexLocker locker(&mutex);
+				listOrder.append(id);
+			}, level);
+		}
+	}
+	// callbacks with deadline (ids 10000 + budget in seconds), zero budget is always missed
+	QList<qint64> listBudgets = QList<qint64>() << 3 << 1 << 0 << 2;
+	for (int i = 0; i < listBudgets.count(); i++)
+	{
+		int id = 10000 + (int)listBudgets.at(i);
+		worker.execInThreadWithDeadline([&mutex, &listOrder, id]() {
+			QMutexLocker locker(&mutex);
+			listOrder.append(id);
+		}, listBudgets.at(i) * 1000000);
+	}
+	// check depths while blocked
+	QList<QLambdaThreadWorkerLevelMetrics> listMetrics = worker.getLevelMetrics();
+	for (int i = 0; i < listMetrics.count(); i++)
+	{
+		QLambdaThreadWorkerLevelMetrics metrics = listMetrics.at(i);
+		int expected = metrics.level == QLAMBDATHREADWORKER_CONTROL_LEVEL ? 0 :
+			           metrics.level == QLAMBDATHREADWORKER_DEADLINE_LEVEL ? listBudgets.count() : numPerLevel;
+		qDebug() << "[INFO] Level" << metrics.level << "depth" << metrics.depth;
+		if (metrics.depth != expected)
+		{
+			qDebug() << "[ERROR] Level" << metrics.level << "expected depth" << expected;
+			return 1;
+		}
+	}
+	gate.release();
+	// wait until all executed
+	bool finished = false;
+	worker.execInThreadAtLevel([&finished]() {
+		finished = true;
+	}, 0);
+	while (!finished)
+	{
+		QCoreApplication::processEvents();
+	}
+	// expected order
+	QList<int> listExpected = QList<int>() << 10000 << 10001 << 10002 << 10003;
+	for (int level = QLAMBDATHREADWORKER_PRIORITY_LEVELS - 1; level >= 0; level--)
+	{
+		for (int i = 0; i < numPerLevel; i++)
+		{
+			listExpected << level * 100 + i;
+		}
+	}
+	qDebug() << "[INFO] Order" << listOrder;
+	if (listOrder != listExpected)
+	{
+		qDebug() << "[ERROR] Expected order" << listExpected;
+		return 1;
+	}
+	QLambdaThreadWorkerStats stats = worker.getStats();
+	if (stats.deadlineMisses != 1)
+	{
+		qDebug() << "[ERROR] Expected one deadline miss, got" << stats.deadlineMisses;
+		return 1;
+	}
+	qDebug() << "[INFO] Test finished successfully.";
+	return 0;
+}
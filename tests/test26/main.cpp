@@ -0,0 +1,141 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <QVector>
+#include <stdexcept>
+#include <cmath>
+
+#include <QLambdaThreadPool>
+#include <QLambdaThreadParallel>
+
+// NOTE : parallelFor and parallelMap must produce the same results as a serial loop, reject when the
+//        function throws, and scale with the number of workers (benchmark from 1 to N threads)
+
+// some cpu bound work per element
+double work(qint64 index)
+{
+	double value = (double)index;
+	for (int i = 0; i < 200; i++)
+	{
+		value = std::sqrt(value + i);
+	}
+	return value;
+}
+
+// wait for deferred processing events, returns true if resolved
+bool waitFor(QDefer defer)
+{
+	bool finished = false;
+	bool resolved = false;
+	defer.done([&finished, &resolved]() {
+		resolved = true;
+		finished = true;
+	}).fail([&finished]() {
+		finished = true;
+	});
+	while (!finished)
+	{
+		QCoreApplication::processEvents();
+	}
+	return resolved;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	const qint64 numElems = 2000000;
+	// serial reference
+	QVector<double> vecExpected(numElems);
+	QElapsedTimer timer;
+	timer.start();
+	for (qint64 i = 0; i < numElems; i++)
+	{
+		vecExpected[i] = work(i);
+	}
+	qint64 nsSerial = timer.nsecsElapsed();
+	qDebug() << "[INFO] Serial" << nsSerial / 1000000 << "ms";
+	// parallelFor over 1 to N workers
+	int maxThreads = QThread::idealThreadCount();
+	for (int numThreads = 1; numThreads <= maxThreads; numThreads++)
+	{
+		QList<QLambdaThreadWorker> listWorkers;
+		for (int i = 0; i < numThreads; i++)
+		{
+			listWorkers.append(QLambdaThreadWorker());
+		}
+		QLambdaThreadParallel parallel(listWorkers);
+		QVector<double> vecResults(numElems);
+		double * p_results = vecResults.data();
+		timer.restart();
+		if (!waitFor(parallel.parallelFor(0, numElems, 1024, [p_results](qint64 index) {
+			p_results[index] = work(index);
+		})))
+		{
+			qDebug() << "[ERROR] parallelFor rejected";
+			return 1;
+		}
+		qint64 nsParallel = timer.nsecsElapsed();
+		qDebug() << "[INFO]" << numThreads << "threads" << nsParallel / 1000000 << "ms, speedup" << (double)nsSerial / nsParallel;
+		if (vecResults != vecExpected)
+		{
+			qDebug() << "[ERROR] parallelFor results differ with" << numThreads << "threads";
+			return 1;
+		}
+		for (int i = 0; i < listWorkers.count(); i++)
+		{
+			waitFor(listWorkers[i].quitThread());
+		}
+	}
+	// parallelMap over a pool
+	QLambdaThreadPool pool;
+	QLambdaThreadParallel parallel(pool);
+	QVector<qint64> vecIndexes(numElems);
+	for (qint64 i = 0; i < numElems; i++)
+	{
+		vecIndexes[i] = i;
+	}
+	QVector<double> vecMapped;
+	bool finished = false;
+	bool resolved = false;
+	timer.restart();
+	parallel.parallelMap(vecIndexes, [](const qint64 &index) {
+		return work(index);
+	}).done([&vecMapped, &finished, &resolved](QVector<double> vecResults) {
+		vecMapped = vecResults;
+		resolved  = true;
+		finished  = true;
+	}).fail([&finished](QVector<double>) {
+		finished = true;
+	});
+	while (!finished)
+	{
+		QCoreApplication::processEvents();
+	}
+	qDebug() << "[INFO] parallelMap over pool" << timer.elapsed() << "ms";
+	if (!resolved || vecMapped != vecExpected)
+	{
+		qDebug() << "[ERROR] parallelMap results differ";
+		return 1;
+	}
+	// empty range resolves right away
+	if (!waitFor(parallel.parallelFor(10, 10, 1, [](qint64) {})))
+	{
+		qDebug() << "[ERROR] Empty range rejected";
+		return 1;
+	}
+	// exception rejects
+	if (waitFor(parallel.parallelFor(0, 1000, 1, [](qint64 index) {
+		if (index == 500)
+		{
+			throw std::runtime_error("element 500");
+		}
+	})))
+	{
+		qDebug() << "[ERROR] parallelFor resolved despite exception";
+		return 1;
+	}
+	waitFor(pool.quitThread());
+	qDebug() << "[INFO] Test finished successfully.";
+	return 0;
+}
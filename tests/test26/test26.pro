@@ -0,0 +1,14 @@
+QT += core
+QT -= gui
+
+TARGET = test26
+CONFIG += console
+CONFIG -= app_bundle
+
+include(./../../src/qlambdathreadworker.pri)
+
+TEMPLATE = app
+
+SOURCES += main.cpp
+
+include(./../add_qt_path.pri)
@@ -0,0 +1,139 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QDebug>
+#include <QVector>
+#include <stdexcept>
+
+#include <QLambdaThreadPool>
+#include <QLambdaThreadStrand>
+
+// NOTE : many strands over a few threads, tasks posted from several producers must run in order per producer
+//        and never concurrently within a strand, run deferreds must call back in the registering thread
+
+// state only accessed through its strand, no locks
+struct Component
+{
+	Component(const QLambdaThreadPool &pool, int numProducers) : strand(pool), counter(0), lastSeq(numProducers, -1) { }
+
+	QLambdaThreadStrand strand;
+	QAtomicInt          inside;
+	int                 counter;
+	QVector<int>        lastSeq;
+	bool                outOfOrder = false;
+	bool                concurrent = false;
+};
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	const int numComponents = 500;
+	const int numProducers  = 4;
+	const int numTasks      = 200;
+	QLambdaThreadPool pool(4);
+	QList<Component *> listComponents;
+	for (int i = 0; i < numComponents; i++)
+	{
+		listComponents.append(new Component(pool, numProducers));
+	}
+	// producers post to every component
+	QElapsedTimer timer;
+	timer.start();
+	QList<QLambdaThreadWorker> listProducers;
+	for (int p = 0; p < numProducers; p++)
+	{
+		listProducers.append(QLambdaThreadWorker());
+		listProducers.last().execInThread([&listComponents, p, numTasks]() {
+			for (int t = 0; t < numTasks; t++)
+			{
+				for (int c = 0; c < listComponents.count(); c++)
+				{
+					Component * p_comp = listComponents.at(c);
+					p_comp->strand.execInThread([p_comp, p, t]() {
+						if (p_comp->inside.fetchAndAddOrdered(1) != 0)
+						{
+							p_comp->concurrent = true;
+						}
+						if (p_comp->lastSeq[p] != t - 1)
+						{
+							p_comp->outOfOrder = true;
+						}
+						p_comp->lastSeq[p] = t;
+						p_comp->counter++;
+						p_comp->inside.fetchAndSubOrdered(1);
+					});
+				}
+			}
+		});
+	}
+	// wait until last task of every component seen through run, in this thread
+	QAtomicInt numDone;
+	bool wrongThread = false;
+	QThread * p_mainThread = QThread::currentThread();
+	for (int i = 0; i < numProducers; i++)
+	{
+		bool quit = false;
+		listProducers[i].quitThread().done([&quit]() { quit = true; });
+		while (!quit)
+		{
+			QCoreApplication::processEvents();
+		}
+	}
+	for (int c = 0; c < listComponents.count(); c++)
+	{
+		Component * p_comp = listComponents.at(c);
+		p_comp->strand.run([p_comp]() {
+			return p_comp->counter;
+		}).done([&numDone, &wrongThread, p_mainThread](int) {
+			wrongThread = wrongThread || QThread::currentThread() != p_mainThread;
+			numDone.fetchAndAddOrdered(1);
+		});
+	}
+	while (numDone.loadAcquire() < numComponents)
+	{
+		QCoreApplication::processEvents();
+	}
+	qDebug() << "[INFO]" << numComponents * numProducers * numTasks << "tasks over" << numComponents << "strands in" << timer.elapsed() << "ms";
+	for (int c = 0; c < listComponents.count(); c++)
+	{
+		Component * p_comp = listComponents.at(c);
+		if (p_comp->concurrent || p_comp->outOfOrder || p_comp->counter != numProducers * numTasks)
+		{
+			qDebug() << "[ERROR] Component" << c << "concurrent" << p_comp->concurrent << "out of order" << p_comp->outOfOrder << "count" << p_comp->counter;
+			return 1;
+		}
+	}
+	if (wrongThread)
+	{
+		qDebug() << "[ERROR] Run callback not executed in registering thread";
+		return 1;
+	}
+	// exceptions reject and do not stall the strand
+	bool rejected = false;
+	bool resolved = false;
+	QLambdaThreadStrand strand(pool);
+	strand.run([]() -> int {
+		throw std::runtime_error("task");
+	}).fail([&rejected](int) {
+		rejected = true;
+	});
+	strand.run([]() {
+		return 1;
+	}).done([&resolved](int) {
+		resolved = true;
+	});
+	while (!rejected || !resolved)
+	{
+		QCoreApplication::processEvents();
+	}
+	qDeleteAll(listComponents);
+	bool quit = false;
+	pool.quitThread().done([&quit]() { quit = true; });
+	while (!quit)
+	{
+		QCoreApplication::processEvents();
+	}
+	qDebug() << "[INFO] Test finished successfully.";
+	return 0;
+}
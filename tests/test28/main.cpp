@@ -0,0 +1,147 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QDebug>
+#include <stdexcept>
+
+#include <QLambdaThreadPool>
+#include <QLambdaThreadPipeline>
+
+// NOTE : producer -> transform -> sink pipeline, items must arrive in order, queues must never grow past
+//        their capacity (backpressure up to the producer), a throwing stage function must only drop
+//        its item and end-to-end throughput is reported
+
+void printMetrics(const QString &strName, const QLambdaThreadStageMetrics &metrics)
+{
+	qDebug() << "[INFO]" << strName << "processed" << metrics.processed << ", items/s" << (qint64)metrics.throughput
+		<< ", occupancy max" << metrics.maxOccupancy << "of" << metrics.capacity << ", blocked" << metrics.blocked
+		<< ", rejected" << metrics.rejected << ", failed" << metrics.failed << ", busy ms" << metrics.busyNs / 1000000;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	// backpressure, slow sink and tiny queues
+	{
+		QLambdaThreadWorker workerB;
+		QLambdaThreadWorker workerC;
+		QAtomicInt received;
+		bool outOfOrder = false;
+		int  lastItem   = -1;
+		QLambdaThreadStage<int> sink(workerC, [&received, &outOfOrder, &lastItem](const int &item) {
+			QThread::usleep(1000);
+			outOfOrder = outOfOrder || item != lastItem + 1;
+			lastItem   = item;
+			received.fetchAndAddOrdered(1);
+		}, 8);
+		QLambdaThreadStage<int> transform(workerB, [](const int &item) {
+			return item;
+		}, sink, 8);
+		// fill everything, pushes must eventually be refused
+		int numPushed = 0;
+		while (transform.tryPush(numPushed))
+		{
+			numPushed++;
+		}
+		bool rejected = false;
+		transform.push(numPushed).fail([&rejected]() {
+			rejected = true;
+		});
+		QCoreApplication::processEvents();
+		qDebug() << "[INFO] Pushed" << numPushed << "items before the pipeline got full";
+		// capacity of both queues plus one pending result in the transform stage (and one in the sink function)
+		if (numPushed > 8 + 8 + 2 || !rejected)
+		{
+			qDebug() << "[ERROR] Pipeline did not refuse items when full";
+			return 1;
+		}
+		// blocking pushes flow at the pace of the sink
+		for (int i = numPushed; i < 1000; i++)
+		{
+			transform.pushBlocking(i);
+		}
+		while (received.loadAcquire() < 1000)
+		{
+			QCoreApplication::processEvents();
+		}
+		printMetrics("Backpressure transform", transform.getMetrics());
+		printMetrics("Backpressure sink", sink.getMetrics());
+		if (outOfOrder || transform.getMetrics().maxOccupancy > 8 || sink.getMetrics().maxOccupancy > 8)
+		{
+			qDebug() << "[ERROR] Items out of order or queue grew past its capacity";
+			return 1;
+		}
+	}
+	// throwing stage function, more items than the capacity so blocking pushes need the stage to keep draining
+	{
+		QLambdaThreadWorker worker;
+		QAtomicInt received;
+		QLambdaThreadStage<int> sink(worker, [&received](const int &item) {
+			if (item % 10 == 0)
+			{
+				throw std::runtime_error("stage failure");
+			}
+			received.fetchAndAddOrdered(1);
+		}, 8);
+		const int numItems = 100;
+		for (int i = 0; i < numItems; i++)
+		{
+			if (!sink.pushBlocking(i, 10000))
+			{
+				qDebug() << "[ERROR] Stage stopped draining after an exception";
+				return 1;
+			}
+		}
+		while (sink.getMetrics().processed < (quint64)numItems)
+		{
+			QCoreApplication::processEvents();
+		}
+		QLambdaThreadStageMetrics metrics = sink.getMetrics();
+		printMetrics("Throwing sink", metrics);
+		if (metrics.failed != (quint64)numItems / 10 || received.loadAcquire() != numItems - numItems / 10)
+		{
+			qDebug() << "[ERROR] Expected" << numItems / 10 << "failed items";
+			return 1;
+		}
+	}
+	// throughput benchmark, transform stage in a pool
+	{
+		const int numItems = 1000000;
+		QLambdaThreadPool   pool(2);
+		QLambdaThreadWorker workerSink;
+		QLambdaThreadWorker workerProducer;
+		QAtomicInt received;
+		qint64     sum = 0;
+		QLambdaThreadStage<qint64> sink(workerSink, [&received, &sum](const qint64 &item) {
+			sum += item;
+			received.fetchAndAddRelease(1);
+		});
+		QLambdaThreadStage<int> transform(pool, [](const int &item) {
+			return (qint64)item * 2;
+		}, sink);
+		QElapsedTimer timer;
+		timer.start();
+		workerProducer.execInThread([transform, numItems]() mutable {
+			for (int i = 0; i < numItems; i++)
+			{
+				transform.pushBlocking(i);
+			}
+		});
+		while (received.loadAcquire() < numItems)
+		{
+			QCoreApplication::processEvents();
+		}
+		qint64 nsElapsed = timer.nsecsElapsed();
+		qDebug() << "[INFO]" << numItems << "items end-to-end in" << nsElapsed / 1000000 << "ms," << (qint64)((double)numItems * 1e9 / nsElapsed) << "items/s";
+		printMetrics("Benchmark transform", transform.getMetrics());
+		printMetrics("Benchmark sink", sink.getMetrics());
+		if (sum != (qint64)numItems * (numItems - 1))
+		{
+			qDebug() << "[ERROR] Wrong sum" << sum;
+			return 1;
+		}
+	}
+	qDebug() << "[INFO] Test finished successfully.";
+	return 0;
+}
@@ -0,0 +1,111 @@
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QFile>
+#include <QDebug>
+
+#include <QLambdaThreadWorker>
+
+// NOTE : traced callbacks must show up in the queue wait and run time histograms, and in a valid chrome
+//        trace export, callbacks queued without tracing must not
+
+void printLatency(const QString &strName, const QLambdaThreadWorkerLatencyStats &stats)
+{
+	qDebug() << "[INFO]" << strName << "count" << stats.count << ", mean us" << stats.meanNs / 1000.0 << ", p50 us" << stats.p50Ns / 1000.0
+		<< ", p99 us" << stats.p99Ns / 1000.0 << ", max us" << stats.maxNs / 1000.0;
+}
+
+// wait until all previously queued callbacks were executed
+void waitIdle(QLambdaThreadWorker &worker)
+{
+	bool finished = false;
+	worker.execInThread([&finished]() {
+		finished = true;
+	}, Qt::LowEventPriority);
+	while (!finished)
+	{
+		QCoreApplication::processEvents();
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QLambdaThreadWorker worker(QLambdaThreadWorkerOptions("traced"));
+	// not traced
+	for (int i = 0; i < 10; i++)
+	{
+		worker.execInThread([]() {});
+	}
+	waitIdle(worker);
+	if (worker.getRunTimeStats().count != 0)
+	{
+		qDebug() << "[ERROR] Callbacks traced while tracing disabled";
+		return 1;
+	}
+	// burst of 2 ms callbacks, the last ones wait for the first ones
+	const int numTasks = 50;
+	worker.setTracingEnabled(true);
+	for (int i = 0; i < numTasks; i++)
+	{
+		worker.execInThread([]() {
+			QThread::msleep(2);
+		});
+	}
+	waitIdle(worker);
+	worker.setTracingEnabled(false);
+	// NOTE : a callback is recorded after it returns, so wait for an untraced one queued behind the
+	//        traced waitIdle callback, by then its record has landed
+	waitIdle(worker);
+	QLambdaThreadWorkerLatencyStats runStats  = worker.getRunTimeStats();
+	QLambdaThreadWorkerLatencyStats waitStats = worker.getQueueWaitStats();
+	printLatency("Run time", runStats);
+	printLatency("Queue wait", waitStats);
+	// waitIdle callback itself is traced too
+	if (runStats.count != (quint64)numTasks + 1 || runStats.p50Ns < 2000000 || waitStats.maxNs < (numTasks - 1) * 2000000LL)
+	{
+		qDebug() << "[ERROR] Unexpected latency histograms";
+		return 1;
+	}
+	// chrome trace
+	QByteArray byteTrace = worker.getChromeTrace();
+	QJsonParseError error;
+	QJsonDocument doc = QJsonDocument::fromJson(byteTrace, &error);
+	if (error.error != QJsonParseError::NoError)
+	{
+		qDebug() << "[ERROR] Invalid chrome trace" << error.errorString();
+		return 1;
+	}
+	int numRuns = 0;
+	QJsonArray arrEvents = doc.object().value("traceEvents").toArray();
+	for (int i = 0; i < arrEvents.count(); i++)
+	{
+		if (arrEvents.at(i).toObject().value("ph").toString() == "X")
+		{
+			numRuns++;
+		}
+	}
+	qDebug() << "[INFO] Chrome trace with" << arrEvents.count() << "events";
+	if (numRuns != numTasks + 1)
+	{
+		qDebug() << "[ERROR] Expected" << numTasks + 1 << "task events, got" << numRuns;
+		return 1;
+	}
+	// view in chrome://tracing or ui.perfetto.dev
+	QFile file("test29_trace.json");
+	if (file.open(QIODevice::WriteOnly))
+	{
+		file.write(byteTrace);
+		file.close();
+	}
+	worker.resetTracing();
+	if (worker.getRunTimeStats().count != 0)
+	{
+		qDebug() << "[ERROR] Histograms not reset";
+		return 1;
+	}
+	qDebug() << "[INFO] Test finished successfully.";
+	return 0;
+}
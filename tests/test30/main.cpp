@@ -0,0 +1,136 @@
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QFile>
+#include <QDebug>
+
+#include <QDeferred>
+#include <QLambdaThreadWorker>
+
+// NOTE : a deferred resolved in a worker thread and chained with 'then' in the main thread must show up in the
+//        chrome trace as linked flows, resolve in the worker thread and callbacks in the main thread
+
+// find begin event by name and deferred id
+QJsonObject findBegin(const QJsonArray &arrEvents, const QString &strName, const int &intId)
+{
+	for (int i = 0; i < arrEvents.count(); i++)
+	{
+		QJsonObject objEvent = arrEvents.at(i).toObject();
+		if (objEvent.value("ph").toString() == "B" && objEvent.value("name").toString() == strName &&
+			objEvent.value("args").toObject().value("id").toInt() == intId)
+		{
+			return objEvent;
+		}
+	}
+	return QJsonObject();
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QLambdaThreadWorker worker;
+	QDeferred<int> defer;
+	int  result   = 0;
+	bool finished = false;
+	defer.then<int>([](int x) {
+		QDeferred<int> deferNext;
+		deferNext.resolve(x + 1);
+		return deferNext;
+	}).done([&result, &finished](int y) {
+		result   = y;
+		finished = true;
+	});
+	// resolve in worker thread, callbacks are queued to main thread
+	worker.execInThread([defer]() mutable {
+		defer.resolve(1);
+	});
+	while (!finished)
+	{
+		QCoreApplication::processEvents();
+	}
+	if (result != 2)
+	{
+		qDebug() << "[ERROR] Unexpected chain result" << result;
+		return 1;
+	}
+	// chrome trace
+	QByteArray byteTrace = QDeferredTrace::takeChromeTrace();
+	QJsonParseError error;
+	QJsonDocument doc = QJsonDocument::fromJson(byteTrace, &error);
+	if (error.error != QJsonParseError::NoError)
+	{
+		qDebug() << "[ERROR] Invalid chrome trace" << error.errorString();
+		return 1;
+	}
+	QJsonArray arrEvents = doc.object().value("traceEvents").toArray();
+	qDebug() << "[INFO] Chrome trace with" << arrEvents.count() << "events";
+	// then link, parent is the deferred resolved in the worker thread
+	int intParent = 0;
+	int intChild  = 0;
+	for (int i = 0; i < arrEvents.count(); i++)
+	{
+		QJsonObject objEvent = arrEvents.at(i).toObject();
+		if (objEvent.value("ph").toString() == "B" && objEvent.value("name").toString() == "then")
+		{
+			intParent = objEvent.value("args").toObject().value("id").toInt();
+			intChild  = objEvent.value("args").toObject().value("link").toInt();
+			break;
+		}
+	}
+	if (intParent == 0 || intChild == 0 || intParent == intChild)
+	{
+		qDebug() << "[ERROR] Missing then link";
+		return 1;
+	}
+	QJsonObject objResolve = findBegin(arrEvents, "resolve", intParent);
+	QJsonObject objDone    = findBegin(arrEvents, "done"   , intParent);
+	if (objResolve.isEmpty() || objDone.isEmpty() || objResolve.value("tid").toInt() == objDone.value("tid").toInt())
+	{
+		qDebug() << "[ERROR] Expected resolve and done callback of the parent in different threads";
+		return 1;
+	}
+	if (findBegin(arrEvents, "create", intChild).isEmpty() || findBegin(arrEvents, "resolve", intChild).isEmpty())
+	{
+		qDebug() << "[ERROR] Missing lifecycle events of the child";
+		return 1;
+	}
+	// every deferred starts a flow on creation
+	int numFlowStarts = 0;
+	for (int i = 0; i < arrEvents.count(); i++)
+	{
+		if (arrEvents.at(i).toObject().value("ph").toString() == "s")
+		{
+			numFlowStarts++;
+		}
+	}
+	if (numFlowStarts < 3)
+	{
+		qDebug() << "[ERROR] Expected at least 3 flows, got" << numFlowStarts;
+		return 1;
+	}
+	if (QDeferredTrace::droppedCount() != 0)
+	{
+		qDebug() << "[ERROR] Unexpected dropped events";
+		return 1;
+	}
+	// incremental flush, view in chrome://tracing or ui.perfetto.dev
+	QFile::remove("test30_trace.json");
+	QDeferred<int> deferMore;
+	deferMore.resolve(3);
+	if (!QDeferredTrace::flush("test30_trace.json") || !QDeferredTrace::flush("test30_trace.json"))
+	{
+		qDebug() << "[ERROR] Could not flush trace file";
+		return 1;
+	}
+	QFile file("test30_trace.json");
+	if (!file.open(QIODevice::ReadOnly) || !file.readAll().startsWith("[\n"))
+	{
+		qDebug() << "[ERROR] Invalid trace file";
+		return 1;
+	}
+	file.close();
+	qDebug() << "[INFO] Test finished successfully.";
+	return 0;
+}
@@ -0,0 +1,17 @@
+QT += core
+QT -= gui
+
+TARGET = test30
+CONFIG += console
+CONFIG -= app_bundle
+
+# compile in the deferred lifecycle tracing
+DEFINES += QDEFERRED_TRACE
+
+include(./../../src/qlambdathreadworker.pri)
+
+TEMPLATE = app
+
+SOURCES += main.cpp
+
+include(./../add_qt_path.pri)
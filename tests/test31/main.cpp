@@ -0,0 +1,70 @@
+#include <QCoreApplication>
+#include <QAtomicInt>
+#include <QDebug>
+
+#include <QLambdaThreadPool>
+
+// NOTE : quitting a pool right after a burst must execute every queued task, also the ones beyond
+//        the batch limit of each drain and the ones submitted by running tasks while quitting
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	const int numThreads      = 4;
+	const int numTasks        = numThreads * QLAMBDATHREADPOOL_MAX_BATCH * 20;
+	const int numContinuation = 100;
+	QLambdaThreadPool pool(numThreads);
+
+	QAtomicInt executed;
+	for (int i = 0; i < numTasks; i++)
+	{
+		pool.execInThread([&executed]() {
+			executed.fetchAndAddRelaxed(1);
+		});
+	}
+	// tasks submitting a continuation from inside the pool
+	QAtomicInt rejected;
+	for (int i = 0; i < numContinuation; i++)
+	{
+		pool.execInThread([pool, &executed, &rejected]() mutable {
+			executed.fetchAndAddRelaxed(1);
+			bool ok = pool.execInThread([&executed]() {
+				executed.fetchAndAddRelaxed(1);
+			});
+			if (!ok)
+			{
+				rejected.fetchAndAddRelaxed(1);
+			}
+		});
+	}
+	// quit right away
+	bool finished = false;
+	pool.quitThread().done([&finished]() {
+		finished = true;
+	});
+	while (!finished)
+	{
+		QCoreApplication::processEvents();
+	}
+	int expected = numTasks + 2 * numContinuation;
+	qDebug() << "[INFO] Executed" << executed.loadAcquire() << "of" << expected << "tasks";
+	if (rejected.loadAcquire() != 0)
+	{
+		qDebug() << "[ERROR] Continuation rejected while quitting";
+		return 1;
+	}
+	if (executed.loadAcquire() != expected)
+	{
+		qDebug() << "[ERROR] Tasks lost when quitting";
+		return 1;
+	}
+	// no new tasks after quit
+	if (pool.execInThread([]() {}))
+	{
+		qDebug() << "[ERROR] Task accepted after quit";
+		return 1;
+	}
+	qDebug() << "[INFO] Test finished successfully.";
+	return 0;
+}
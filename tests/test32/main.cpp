@@ -0,0 +1,176 @@
+#include <QCoreApplication>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QDebug>
+
+#include <QLambdaThreadWorker>
+
+// NOTE : functions of a batch must run in order and release their captures once executed, a callback queued
+//        while a yielding batch executes must run between its chunks, a loop of the worker must tick in the
+//        middle of a long yielding batch (event loop runs between chunks), and a batch counts once in the stats
+
+// destroyed when the last function capturing it is released
+struct Tracker
+{
+	explicit Tracker(QAtomicInt * p_destroyed) : mp_destroyed(p_destroyed) { }
+	~Tracker() { mp_destroyed->fetchAndAddOrdered(1); }
+	QAtomicInt * mp_destroyed;
+};
+
+// wait until every submitted callback is executed and counted
+void waitCounted(QLambdaThreadWorker &worker)
+{
+	bool finished = false;
+	worker.execInThread([&finished]() {
+		finished = true;
+	});
+	while (!finished || worker.getStats().executed != worker.getStats().submitted)
+	{
+		QCoreApplication::processEvents();
+	}
+}
+
+// run a batch of numFuncs functions, function 0 queues a marker callback (-1)
+QList<int> runBatch(QLambdaThreadWorker &worker, const int &numFuncs, const int &intYieldEvery)
+{
+	QMutex     mutex;
+	QList<int> listOrder;
+	QList<std::function<void()>> listFuncs;
+	for (int i = 0; i < numFuncs; i++)
+	{
+		listFuncs.append([&worker, &mutex, &listOrder, i]() {
+			if (i == 0)
+			{
+				worker.execInThread([&mutex, &listOrder]() {
+					QMutexLocker locker(&mutex);
+					listOrder.append(-1);
+				});
+			}
+			QMutexLocker locker(&mutex);
+			listOrder.append(i);
+		});
+	}
+	worker.execBatchInThread(listFuncs, intYieldEvery);
+	waitCounted(worker);
+	return listOrder;
+}
+
+// number of loop ticks while a batch of slow functions was half way
+int countMidBatchTicks(QLambdaThreadWorker &worker, const int &intYieldEvery)
+{
+	const int  numFuncs = 100;
+	QAtomicInt progress;
+	QAtomicInt midTicks;
+	int loopId = worker.startLoopInThread([&progress, &midTicks, numFuncs]() {
+		int executed = progress.loadAcquire();
+		if (executed > 0 && executed < numFuncs)
+		{
+			midTicks.fetchAndAddOrdered(1);
+		}
+	}, 5);
+	QList<std::function<void()>> listFuncs;
+	for (int i = 0; i < numFuncs; i++)
+	{
+		listFuncs.append([&progress]() {
+			QThread::msleep(2);
+			progress.fetchAndAddOrdered(1);
+		});
+	}
+	worker.execBatchInThread(listFuncs, intYieldEvery);
+	waitCounted(worker);
+	bool stopped = false;
+	worker.stopLoopInThread(loopId).done([&stopped]() {
+		stopped = true;
+	});
+	while (!stopped)
+	{
+		QCoreApplication::processEvents();
+	}
+	return midTicks.loadAcquire();
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QLambdaThreadWorker worker;
+	// in order, marker after the whole batch
+	QList<int> listExpected;
+	for (int i = 0; i < 100; i++)
+	{
+		listExpected << i;
+	}
+	listExpected << -1;
+	QList<int> listOrder = runBatch(worker, 100, 0);
+	if (listOrder != listExpected)
+	{
+		qDebug() << "[ERROR] Unexpected order without yield" << listOrder;
+		return 1;
+	}
+	// yield every 10, marker between the first and second chunks
+	listExpected.removeLast();
+	listExpected.insert(10, -1);
+	QLambdaThreadWorkerStats statsBefore = worker.getStats();
+	listOrder = runBatch(worker, 100, 10);
+	QLambdaThreadWorkerStats statsAfter = worker.getStats();
+	if (listOrder != listExpected)
+	{
+		qDebug() << "[ERROR] Unexpected order with yield" << listOrder;
+		return 1;
+	}
+	qDebug() << "[INFO] Callback queued mid-batch ran between chunks";
+	// batch, marker and waitCounted callbacks, continuations are not counted
+	quint64 submitted = statsAfter.submitted - statsBefore.submitted;
+	quint64 executed  = statsAfter.executed  - statsBefore.executed;
+	if (submitted != 3 || executed != 3)
+	{
+		qDebug() << "[ERROR] Expected batch counted once, got submitted" << submitted << ", executed" << executed;
+		return 1;
+	}
+	// event loop runs between chunks of a yielding batch only
+	int midTicksNoYield = countMidBatchTicks(worker, 0);
+	int midTicksYield   = countMidBatchTicks(worker, 5);
+	qDebug() << "[INFO] Loop ticks in the middle of a batch, without yield" << midTicksNoYield << ", with yield" << midTicksYield;
+	if (midTicksNoYield != 0 || midTicksYield == 0)
+	{
+		qDebug() << "[ERROR] Batch did not yield to the event loop";
+		return 1;
+	}
+	// captures released once each function is executed
+	const int numFuncs = 50;
+	QAtomicInt destroyed;
+	QAtomicInt notReleased;
+	QSemaphore started;
+	QSemaphore gate;
+	worker.execInThread([&started, &gate]() {
+		started.release();
+		gate.acquire();
+	});
+	started.acquire();
+	{
+		QList<std::function<void()>> listFuncs;
+		for (int i = 0; i < numFuncs; i++)
+		{
+			QSharedPointer<Tracker> p_tracker(new Tracker(&destroyed));
+			listFuncs.append([p_tracker, &destroyed, &notReleased, i]() {
+				// trackers of the previous functions must be gone
+				if (destroyed.loadAcquire() < i)
+				{
+					notReleased.fetchAndAddOrdered(1);
+				}
+			});
+		}
+		worker.execBatchInThread(listFuncs, 7);
+	}
+	gate.release();
+	waitCounted(worker);
+	if (notReleased.loadAcquire() != 0 || destroyed.loadAcquire() != numFuncs)
+	{
+		qDebug() << "[ERROR] Captures not released after execution, destroyed" << destroyed.loadAcquire();
+		return 1;
+	}
+	qDebug() << "[INFO] Test finished successfully.";
+	return 0;
+}
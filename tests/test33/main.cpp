@@ -0,0 +1,179 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <stdexcept>
+
+#include <QLambdaThreadWorker>
+
+// NOTE : run() must resolve with the return value of the function (or without arguments if it returns void),
+//        and reject if the function throws, with a default value if the return type has one, else only
+//        the state changes (no argument for the fail callbacks)
+
+// return type without default constructor
+struct NoDefault
+{
+	explicit NoDefault(const int &intValue) : value(intValue) { }
+	int value;
+};
+
+// process events until deferred is resolved or rejected
+template<class ...Types>
+QDeferredState waitFinished(QDeferred<Types...> defer)
+{
+	while (defer.state() == QDeferredState::PENDING)
+	{
+		QCoreApplication::processEvents();
+	}
+	return defer.state();
+}
+
+// callbacks of a deferred finished in the worker are queued to this thread before the worker runs the next task
+void waitCallbacks(QLambdaThreadWorker &worker)
+{
+	bool finished = false;
+	worker.run([]() {}).done([&finished]() {
+		finished = true;
+	});
+	while (!finished)
+	{
+		QCoreApplication::processEvents();
+	}
+	QCoreApplication::processEvents();
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QLambdaThreadWorker worker;
+	QThread * p_workerThread = worker.getThread();
+
+	// value returning
+	int  result      = 0;
+	bool inWorker    = false;
+	auto deferValue  = worker.run([p_workerThread, &inWorker]() {
+		inWorker = QThread::currentThread() == p_workerThread;
+		return 42;
+	});
+	deferValue.done([&result](int value) {
+		result = value;
+	});
+	if (waitFinished(deferValue) != QDeferredState::RESOLVED)
+	{
+		qDebug() << "[ERROR] Value returning run not resolved";
+		return 1;
+	}
+	waitCallbacks(worker);
+	if (result != 42 || !inWorker)
+	{
+		qDebug() << "[ERROR] Unexpected result" << result << "or thread";
+		return 1;
+	}
+	// void
+	bool executed = false;
+	QDefer deferVoid = worker.run([&executed]() {
+		executed = true;
+	});
+	if (waitFinished(deferVoid) != QDeferredState::RESOLVED || !executed)
+	{
+		qDebug() << "[ERROR] Void run not resolved";
+		return 1;
+	}
+	// throwing, value returning rejects with default value
+	bool failCalled = false;
+	int  failValue  = -1;
+	QDeferred<int> deferThrow = worker.run([]() -> int {
+		throw std::runtime_error("run failure");
+	});
+	deferThrow.fail([&failCalled, &failValue](int value) {
+		failCalled = true;
+		failValue  = value;
+	});
+	if (waitFinished(deferThrow) != QDeferredState::REJECTED)
+	{
+		qDebug() << "[ERROR] Throwing run not rejected";
+		return 1;
+	}
+	waitCallbacks(worker);
+	if (!failCalled || failValue != 0)
+	{
+		qDebug() << "[ERROR] Fail callback not called with default value";
+		return 1;
+	}
+	// throwing, void
+	bool failVoidCalled = false;
+	QDefer deferThrowVoid = worker.run([]() {
+		throw 1;
+	});
+	deferThrowVoid.fail([&failVoidCalled]() {
+		failVoidCalled = true;
+	});
+	if (waitFinished(deferThrowVoid) != QDeferredState::REJECTED)
+	{
+		qDebug() << "[ERROR] Throwing void run not rejected";
+		return 1;
+	}
+	waitCallbacks(worker);
+	if (!failVoidCalled)
+	{
+		qDebug() << "[ERROR] Fail callback of void run not called";
+		return 1;
+	}
+	// no default constructor, resolves with the value but rejects without arguments
+	int noDefaultValue = 0;
+	QDeferred<NoDefault> deferNoDefault = worker.run([]() {
+		return NoDefault(7);
+	});
+	deferNoDefault.done([&noDefaultValue](NoDefault value) {
+		noDefaultValue = value.value;
+	});
+	if (waitFinished(deferNoDefault) != QDeferredState::RESOLVED)
+	{
+		qDebug() << "[ERROR] Run without default constructible result not resolved";
+		return 1;
+	}
+	waitCallbacks(worker);
+	if (noDefaultValue != 7)
+	{
+		qDebug() << "[ERROR] Unexpected result" << noDefaultValue;
+		return 1;
+	}
+	bool failNoDefaultCalled = false;
+	QDeferred<NoDefault> deferNoDefaultThrow = worker.run([]() -> NoDefault {
+		throw std::runtime_error("run failure");
+	});
+	deferNoDefaultThrow.fail([&failNoDefaultCalled](NoDefault) {
+		failNoDefaultCalled = true;
+	});
+	if (waitFinished(deferNoDefaultThrow) != QDeferredState::REJECTED)
+	{
+		qDebug() << "[ERROR] Throwing run without default constructible result not rejected";
+		return 1;
+	}
+	waitCallbacks(worker);
+	if (failNoDefaultCalled)
+	{
+		qDebug() << "[ERROR] Fail callback called without a value to pass";
+		return 1;
+	}
+	// thread not running, rejected right away and only once
+	QLambdaThreadWorker stoppedWorker;
+	if (waitFinished(stoppedWorker.quitThread()) != QDeferredState::RESOLVED)
+	{
+		qDebug() << "[ERROR] Worker did not quit";
+		return 1;
+	}
+	int failStoppedCount = 0;
+	QDeferred<int> deferStopped = stoppedWorker.run([]() {
+		return 1;
+	});
+	deferStopped.fail([&failStoppedCount](int) {
+		failStoppedCount++;
+	});
+	if (deferStopped.state() != QDeferredState::REJECTED || failStoppedCount != 1)
+	{
+		qDebug() << "[ERROR] Run in stopped worker, fail callback called" << failStoppedCount << "times";
+		return 1;
+	}
+	qDebug() << "[INFO] Test finished successfully.";
+	return 0;
+}
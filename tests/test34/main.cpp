@@ -0,0 +1,99 @@
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <QDynamicEvents>
+
+// NOTE : direct callbacks can unsubscribe themselves (or everything) while being called,
+//        the running callback must finish and the remaining ones must not be called anymore
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QDynamicEvents<int> eventer;
+	int intValue = 1;
+
+	// on callback unsubscribes itself with off(handle)
+	int intSelfCalls = 0;
+	int intSelfValue = 0;
+	QDynamicEventsHandle handleSelf;
+	handleSelf = eventer.on("self", [&eventer, &handleSelf, &intSelfCalls, &intSelfValue](int &value) {
+		eventer.off(handleSelf);
+		// captures must still be alive after the slot was released
+		intSelfCalls++;
+		intSelfValue = value;
+	});
+	eventer.trigger("self", intValue);
+	eventer.trigger("self", intValue);
+	if (intSelfCalls != 1 || intSelfValue != intValue)
+	{
+		qDebug() << "[ERROR] on callback removed with off(handle) called" << intSelfCalls << "times, value" << intSelfValue;
+		return 1;
+	}
+
+	// once callback unsubscribes itself with off(handle)
+	int intOnceCalls = 0;
+	QDynamicEventsHandle handleOnce;
+	handleOnce = eventer.once("once", [&eventer, &handleOnce, &intOnceCalls](int &) {
+		eventer.off(handleOnce);
+		intOnceCalls++;
+	});
+	eventer.trigger("once", intValue);
+	eventer.trigger("once", intValue);
+	if (intOnceCalls != 1)
+	{
+		qDebug() << "[ERROR] once callback removed with off(handle) called" << intOnceCalls << "times";
+		return 1;
+	}
+
+	// callback removes everything with off(), others subscribed to the same event are not called anymore
+	int intAllCalls  = 0;
+	int intOtherOn   = 0;
+	int intOtherOnce = 0;
+	eventer.on("all", [&eventer, &intAllCalls](int &) {
+		eventer.off();
+		intAllCalls++;
+	});
+	eventer.on("all", [&intOtherOn](int &) {
+		intOtherOn++;
+	});
+	eventer.once("all", [&intOtherOnce](int &) {
+		intOtherOnce++;
+	});
+	eventer.trigger("all", intValue);
+	eventer.trigger("all", intValue);
+	if (intAllCalls != 1 || intOtherOn != 0 || intOtherOnce != 0)
+	{
+		qDebug() << "[ERROR] off() inside a callback, called" << intAllCalls << "times, others" << intOtherOn << intOtherOnce;
+		return 1;
+	}
+
+	// once callback removes everything with off()
+	int intOnceAllCalls = 0;
+	eventer.once("onceall", [&eventer, &intOnceAllCalls](int &) {
+		eventer.off();
+		intOnceAllCalls++;
+	});
+	eventer.trigger("onceall", intValue);
+	eventer.trigger("onceall", intValue);
+	if (intOnceAllCalls != 1)
+	{
+		qDebug() << "[ERROR] off() inside a once callback, called" << intOnceAllCalls << "times";
+		return 1;
+	}
+
+	// eventer is still usable afterwards
+	int intAfterCalls = 0;
+	eventer.on("after", [&intAfterCalls](int &) {
+		intAfterCalls++;
+	});
+	eventer.trigger("after", intValue);
+	if (intAfterCalls != 1)
+	{
+		qDebug() << "[ERROR] subscribing after off() failed";
+		return 1;
+	}
+
+	qDebug() << "[INFO] Test finished successfully.";
+	return 0;
+}
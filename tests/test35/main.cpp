@@ -0,0 +1,115 @@
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <QEventer>
+
+// NOTE : signatures subscribed under shared event names live in separate typed eventers, removing one
+//        subscription (by handle or by name) must leave the other signatures and names working
+
+struct Counters
+{
+	Counters() : intAlpha(0), strAlpha(0), dblAlpha(0), dblBeta(0), intBeta(0) { }
+	bool equals(int a, int b, int c, int d, int e) const
+	{
+		return intAlpha == a && strAlpha == b && dblAlpha == c && dblBeta == d && intBeta == e;
+	}
+	int intAlpha;
+	int strAlpha;
+	int dblAlpha;
+	int dblBeta;
+	int intBeta;
+};
+
+void triggerAll(QEventer &eventer)
+{
+	int     intVal = 1;
+	double  dblVal = 2.0;
+	QString strVal = "three";
+	eventer.trigger<int>("alpha beta", intVal);
+	eventer.trigger<double>("alpha beta", dblVal);
+	eventer.trigger<QString>("alpha beta", strVal);
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QEventer eventer;
+	Counters counters;
+	// NOTE : explicit std::function (callbacks and filters) so Types... can be deduced
+	std::function<void(int&)> intAlphaCallback = [&counters](int &) {
+		counters.intAlpha++;
+	};
+	std::function<void(QString&)> strAlphaCallback = [&counters](QString &) {
+		counters.strAlpha++;
+	};
+	std::function<void(double&)> dblAlphaCallback = [&counters](double &) {
+		counters.dblAlpha++;
+	};
+	std::function<void(double&)> dblBetaCallback = [&counters](double &) {
+		counters.dblBeta++;
+	};
+	std::function<void(int&)> intBetaCallback = [&counters](int &) {
+		counters.intBeta++;
+	};
+	// no filtering
+	std::function<bool(int&)>     intFilter;
+	std::function<bool(QString&)> strFilter;
+	std::function<bool(double&)>  dblFilter;
+	eventer.on<int>("alpha", intAlphaCallback, intFilter);
+	auto handleStr = eventer.on<QString>("alpha", strAlphaCallback, strFilter);
+	// NOTE : a single callback subscribed to both names, called once per name triggered
+	eventer.on<double>("alpha beta", dblAlphaCallback, dblFilter);
+	eventer.on<double>("beta", dblBetaCallback, dblFilter);
+	eventer.on<int>("beta", intBetaCallback, intFilter);
+
+	triggerAll(eventer);
+	if (!counters.equals(1, 1, 2, 1, 1))
+	{
+		qDebug() << "[ERROR] Unexpected calls before any off";
+		return 1;
+	}
+
+	// off by handle only removes that signature
+	eventer.off(handleStr);
+	counters = Counters();
+	triggerAll(eventer);
+	if (!counters.equals(1, 0, 2, 1, 1))
+	{
+		qDebug() << "[ERROR] off(handle) affected other signatures";
+		return 1;
+	}
+
+	// off by name removes every signature under that name, the others names keep working
+	eventer.off("beta");
+	counters = Counters();
+	triggerAll(eventer);
+	if (!counters.equals(1, 0, 1, 0, 0))
+	{
+		qDebug() << "[ERROR] off(name) removed" << counters.intAlpha << counters.dblAlpha << "or kept" << counters.dblBeta << counters.intBeta;
+		return 1;
+	}
+
+	// name can be subscribed again after off(name)
+	eventer.on<int>("beta", intBetaCallback, intFilter);
+	counters = Counters();
+	triggerAll(eventer);
+	if (!counters.equals(1, 0, 1, 0, 1))
+	{
+		qDebug() << "[ERROR] Subscription after off(name) not called";
+		return 1;
+	}
+
+	// off by name of a signature never subscribed to it is harmless
+	eventer.off("gamma");
+	counters = Counters();
+	triggerAll(eventer);
+	if (!counters.equals(1, 0, 1, 0, 1))
+	{
+		qDebug() << "[ERROR] off(name) of an unknown name affected subscriptions";
+		return 1;
+	}
+
+	qDebug() << "[INFO] Test finished successfully.";
+	return 0;
+}
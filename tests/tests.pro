@@ -15,4 +15,26 @@ SUBDIRS = \
 ./test10/test10.pro \
 ./test11/test11.pro \
 ./test12/test12.pro \
-./test13/test13.pro \
\ No newline at end of file
+./test13/test13.pro \
+./test14/test14.pro \
+./test15/test15.pro \
+./test16/test16.pro \
+./test17/test17.pro \
+./test18/test18.pro \
+./test19/test19.pro \
+./test20/test20.pro \
+./test21/test21.pro \
+./test22/test22.pro \
+./test23/test23.pro \
+./test24/test24.pro \
+./test25/test25.pro \
+./test26/test26.pro \
+./test27/test27.pro \
+./test28/test28.pro \
+./test29/test29.pro \
+./test30/test30.pro \
+./test31/test31.pro \
+./test32/test32.pro \
+./test33/test33.pro \
+./test34/test34.pro \
+./test35/test35.pro \
\ No newline at end of file